@@ -0,0 +1,77 @@
+# Checks the linker map of the firmware and fails if the firmware's own code calls a heap allocator.
+# The linker only keeps the sections reachable from the entry point, so an allocator in the
+# map means some code in the image can call it; the cross reference table (-Wl,--cref) tells
+# which objects reference it.
+#  - Referenced by one of the firmware's objects (OWN_OBJECTS): the build fails.
+#  - Referenced only by the SDK or the C library: a warning lists the callers, since those
+#    come with pico_runtime (pico_malloc wraps malloc with --wrap) and are not part of the frame path.
+# A map without a cross reference table, or without the firmware's own objects, fails the
+# check too, so a missing --cref or a stale map cannot pass silently.
+# `free` is not checked: the C library exit path may reference it, and with no allocator
+# called there is nothing to free.
+# Usage: cmake -DMAP=<linker map> -DELF=<linked image> -DOWN_OBJECTS=<regex> -P check_no_heap.cmake
+
+set(HEAP_SYMBOLS
+        malloc calloc realloc memalign
+        _malloc_r _calloc_r _realloc_r _memalign_r
+        __wrap_malloc __wrap_calloc __wrap_realloc __wrap_memalign
+        )
+
+if (NOT EXISTS "${MAP}")
+    message(FATAL_ERROR "check_no_heap: linker map ${MAP} not found")
+endif()
+file(READ "${MAP}" map)
+
+# Discarded sections are listed before the memory map; only what follows it was linked
+string(FIND "${map}" "Linker script and memory map" memory_map_start)
+if (memory_map_start EQUAL -1)
+    message(FATAL_ERROR "check_no_heap: ${MAP} has no memory map")
+endif()
+string(SUBSTRING "${map}" ${memory_map_start} -1 memory_map)
+
+string(FIND "${memory_map}" "Cross Reference Table" cross_references_start)
+if (cross_references_start EQUAL -1)
+    message(FATAL_ERROR "check_no_heap: ${MAP} has no cross reference table; link with -Wl,--cref")
+endif()
+string(SUBSTRING "${memory_map}" ${cross_references_start} -1 cross_references)
+string(SUBSTRING "${memory_map}" 0 ${cross_references_start} memory_map)
+
+if (NOT memory_map MATCHES "${OWN_OBJECTS}")
+    message(FATAL_ERROR "check_no_heap: no object matching ${OWN_OBJECTS} in ${MAP}; nothing of the firmware would be checked")
+endif()
+
+foreach(symbol ${HEAP_SYMBOLS})
+    # Symbols of a kept section are listed as "<address> <symbol>" lines
+    if (NOT memory_map MATCHES "\n[ \t]+0x[0-9a-fA-F]+[ \t]+${symbol}[ \t]*\n")
+        continue()
+    endif()
+
+    # Cross reference entry: the symbol and its defining file, then one indented line per referencing file
+    set(references "")
+    if (cross_references MATCHES "\n${symbol}([ \t][^\n]*)?(\n[ \t]+[^\n]*)*")
+        string(REGEX REPLACE "^\n${symbol}" "" entry "${CMAKE_MATCH_0}")
+        string(REGEX REPLACE "[ \t]*\n[ \t]*" ";" entry "${entry}")
+        string(STRIP "${entry}" entry)
+        foreach(file ${entry})
+            string(STRIP "${file}" file)
+            if (file)
+                list(APPEND references "${file}")
+            endif()
+        endforeach()
+        if (references)
+            list(REMOVE_AT references 0) # The defining file
+        endif()
+    endif()
+
+    set(own_references ${references})
+    list(FILTER own_references INCLUDE REGEX "${OWN_OBJECTS}")
+    list(JOIN references "\n  " references)
+    if (own_references)
+        list(JOIN own_references "\n  " own_references)
+
+        # Drop the image so the next build links (and checks) again
+        file(REMOVE "${ELF}")
+        message(FATAL_ERROR "check_no_heap: ${symbol} is called by the firmware; the frame path must not use the heap:\n  ${own_references}")
+    endif()
+    message(WARNING "check_no_heap: ${symbol} is linked into ${ELF}, referenced only by the SDK or the C library:\n  ${references}")
+endforeach()
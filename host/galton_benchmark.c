@@ -0,0 +1,7 @@
+#include <stdio.h>
+#include "include/galton/galton.h"
+
+int main() {
+    board_benchmark();
+    return 0;
+}
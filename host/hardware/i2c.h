@@ -0,0 +1,8 @@
+#ifndef __HOST_HARDWARE_I2C_H__ // Caso já tenha sido declarada em algum outro lugar, não declare novamente.
+#define __HOST_HARDWARE_I2C_H__
+
+#include "pico/stdlib.h"
+
+typedef struct i2c_inst i2c_inst_t; // Only used through pointers by the display headers
+
+#endif
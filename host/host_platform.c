@@ -0,0 +1,32 @@
+#include <time.h>
+#include "pico/stdlib.h"
+#include "pico/rand.h"
+#include "include/oled_display/oled_display.h"
+
+/**
+ * @brief Returns the time since start-up in microseconds, from the host monotonic clock.
+ */
+uint64_t time_us_64() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000u + (uint64_t)now.tv_nsec / 1000u;
+}
+
+/**
+ * @brief Returns a pseudo-random 32-bit number (xorshift64), reproducible between runs.
+ */
+uint32_t get_rand_32() {
+    static uint64_t state = 88172645463325252u;
+
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return (uint32_t)(state >> 32);
+}
+
+/**
+ * @brief Host stand-in for the display: nothing is sent.
+ */
+bool oled_display_update_board(char board[ssd1306_width][ssd1306_height], uint16_t ball_count, char *status[], uint8_t n_status) {
+    return false;
+}
@@ -0,0 +1,4 @@
+#ifndef __HOST_PICO_BINARY_INFO_H__ // Caso já tenha sido declarada em algum outro lugar, não declare novamente.
+#define __HOST_PICO_BINARY_INFO_H__
+
+#endif
@@ -0,0 +1,8 @@
+#ifndef __HOST_PICO_RAND_H__ // Caso já tenha sido declarada em algum outro lugar, não declare novamente.
+#define __HOST_PICO_RAND_H__
+
+#include <stdint.h>
+
+uint32_t get_rand_32();
+
+#endif
@@ -0,0 +1,19 @@
+#ifndef __HOST_PICO_STDLIB_H__ // Caso já tenha sido declarada em algum outro lugar, não declare novamente.
+#define __HOST_PICO_STDLIB_H__
+
+// Host stand-in for the parts of pico/stdlib.h used by the simulation
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+typedef unsigned int uint;
+
+#define _u(x)       x##u
+#define count_of(a) (sizeof(a) / sizeof((a)[0]))
+#define MIN(a, b)   ((b) > (a) ? (a) : (b))
+#define MAX(a, b)   ((a) > (b) ? (a) : (b))
+
+uint64_t time_us_64();
+
+#endif
@@ -0,0 +1,51 @@
+#include <stdio.h>
+#include <string.h>
+#include "include/power/power_policy.h"
+
+// Replays frame traces through the power scheduler and prints the mode chosen after each frame.
+// One character per frame:
+//   '#'      balls moving or display changed
+//   '.'      nothing changed
+//   'A', 'B' nothing changed, but a button was pressed (wake request)
+// Usage: ./power_trace [trace...]; without arguments the built-in traces are replayed.
+
+static const char *default_traces[] = {
+    "##########..................................................",  // Board settles, goes idle after POWER_IDLE_AFTER_FRAMES
+    "#####....................#####...............................", // Activity just before the deadline restarts the count
+    ".....................................A.....................",   // Button A wakes an idle board
+    "..................................B#######.......................", // Button B starts a new batch
+};
+
+static void replay(const char *trace) {
+    power_policy_struct policy;
+    power_policy_init(&policy);
+
+    printf("trace: %s\n", trace);
+    printf("mode:  ");
+    const size_t frames = strlen(trace);
+    for (size_t frame = 0; frame < frames; frame++) {
+        const char event      = trace[frame];
+        const bool wake       = event == 'A' || event == 'B';
+        const power_mode mode = power_policy_step(&policy, event == '#', wake);
+        putchar(mode == POWER_ACTIVE ? 'a' : 'i');
+    }
+    printf("\n");
+
+    // Same sequence as transitions, to read off the frame where each switch happens
+    power_policy_init(&policy);
+    for (size_t frame = 0; frame < frames; frame++) {
+        const power_mode previous = policy.mode;
+        const power_mode next     = power_policy_step(&policy, trace[frame] == '#', trace[frame] == 'A' || trace[frame] == 'B');
+        if (next != previous) printf("frame %zu: %s\n", frame, next == POWER_ACTIVE ? "active" : "idle");
+    }
+    printf("\n");
+}
+
+int main(int argc, char *argv[]) {
+    if (argc > 1) {
+        for (int i = 1; i < argc; i++) replay(argv[i]);
+    } else {
+        for (size_t i = 0; i < sizeof(default_traces) / sizeof(default_traces[0]); i++) replay(default_traces[i]);
+    }
+    return 0;
+}
@@ -0,0 +1,156 @@
+#include "convergence.h"
+#include <stdio.h>
+#include <math.h>
+
+/**
+ * @brief Computes the upper tail probability of the chi-square distribution.
+ * Uses the closed forms for integer degrees of freedom: a finite Poisson sum for an
+ * even count, and erfc plus a finite series for an odd one.
+ *
+ * @param chi_square The chi-square statistic.
+ * @param degrees Degrees of freedom.
+ * @return P(X >= chi_square) for X ~ chi-square(degrees).
+ */
+static float chi_square_p_value(float chi_square, uint8_t degrees) {
+    const float half = chi_square / 2.0f;
+    float term, p_value;
+
+    if (degrees % 2 == 0) {
+        term    = expf(-half);
+        p_value = term;
+        for (uint8_t i = 1; i < degrees / 2; i++) {
+            term    *= half / (float)i;
+            p_value += term;
+        }
+    } else {
+        const float root = sqrtf(chi_square);
+        p_value = erfcf(root / sqrtf(2.0f));
+        term    = root * expf(-half) * sqrtf(2.0f / (float)M_PI);
+        for (uint8_t k = 1; k <= (degrees - 1) / 2; k++) {
+            p_value += term;
+            term    *= chi_square / (float)(2*k + 1);
+        }
+    }
+    return p_value > 1.0f ? 1.0f : p_value;
+}
+
+/**
+ * @brief Configures the stop condition and clears the statistics.
+ * Also tabulates the Binomial(PIN_LINES, 0.5) probabilities used as reference.
+ *
+ * @param stats Pointer to the convergence structure.
+ * @param tolerance Largest accepted KS distance to the binomial, DKW half-width included.
+ * @param alpha The DKW band holds with confidence 1 - alpha.
+ * @param min_balls Minimum number of landed balls before stopping.
+ * @param action What to do once converged.
+ */
+void convergence_init(convergence_struct *stats, float tolerance, float alpha, uint16_t min_balls, convergence_action action) {
+    stats->tolerance = tolerance;
+    stats->alpha     = alpha;
+    stats->min_balls = min_balls;
+    stats->action    = action;
+
+    // C(n, k) / 2^n, building each coefficient from the previous one
+    float coefficient = 1.0f;
+    for (uint8_t k = 0; k < CONVERGENCE_BINS; k++) {
+        stats->expected[k] = coefficient / (float)(1u << PIN_LINES);
+        coefficient = coefficient * (float)(PIN_LINES - k) / (float)(k + 1);
+    }
+
+    convergence_reset(stats);
+}
+
+/**
+ * @brief Clears the statistics, keeping the stop condition.
+ *
+ * @param stats Pointer to the convergence structure.
+ */
+void convergence_reset(convergence_struct *stats) {
+    stats->count = 0;
+    for (uint8_t k = 0; k < CONVERGENCE_BINS; k++) {
+        stats->bin_counts[k] = 0;
+    }
+    stats->mean        = 0.0f;
+    stats->m2          = 0.0f;
+    stats->chi_square  = 0.0f;
+    stats->p_value     = 0.0f;
+    stats->ks_distance = 1.0f;
+    stats->ks_bound    = 1.0f;
+    stats->converged   = false;
+}
+
+/**
+ * @brief Adds a landed ball to the statistics.
+ * Mean and variance are updated with Welford's method; the chi-square statistic
+ * and the KS distance to the binomial are recomputed over the CONVERGENCE_BINS bins,
+ * so the cost per ball does not depend on how many balls have landed.
+ *
+ * The run is considered converged once at least `min_balls` balls landed and, with
+ * confidence 1 - alpha, the distribution is within `tolerance` of the binomial: the
+ * empirical KS distance plus the Dvoretzky-Kiefer-Wolfowitz half-width
+ * sqrt(ln(2/alpha) / 2n) must not exceed the tolerance. The half-width shrinks with n,
+ * so the stop comes from the data and not from `min_balls`. The tolerance sits below
+ * the smallest bin mass, so a board that misses or overfills a bin never converges,
+ * and a run can only stop once its own histogram is within `tolerance` minus the
+ * half-width of the binomial. Once reached, the converged flag stays set until reset.
+ *
+ * @param stats Pointer to the convergence structure.
+ * @param bin Drop zone of the ball, from 0 (leftmost) to PIN_LINES.
+ */
+void convergence_add(convergence_struct *stats, uint8_t bin) {
+    if (bin >= CONVERGENCE_BINS) return;
+
+    stats->count++;
+    stats->bin_counts[bin]++;
+
+    const float n     = (float)stats->count;
+    const float delta = (float)bin - stats->mean;
+    stats->mean += delta / n;
+    stats->m2   += delta * ((float)bin - stats->mean);
+
+    float chi_square     = 0.0f;
+    float ks_distance    = 0.0f;
+    float observed_cdf   = 0.0f;
+    float expected_cdf   = 0.0f;
+    for (uint8_t k = 0; k < CONVERGENCE_BINS; k++) {
+        const float expected = n * stats->expected[k];
+        const float error    = (float)stats->bin_counts[k] - expected;
+        chi_square += error * error / expected;
+
+        observed_cdf += (float)stats->bin_counts[k] / n;
+        expected_cdf += stats->expected[k];
+        if (fabsf(observed_cdf - expected_cdf) > ks_distance) ks_distance = fabsf(observed_cdf - expected_cdf);
+    }
+
+    stats->chi_square  = chi_square;
+    stats->p_value     = chi_square_p_value(chi_square, CONVERGENCE_BINS - 1);
+    stats->ks_distance = ks_distance;
+    stats->ks_bound    = sqrtf(logf(2.0f / stats->alpha) / (2.0f * n));
+    stats->converged   = stats->converged || (stats->count >= stats->min_balls && stats->ks_distance + stats->ks_bound <= stats->tolerance);
+}
+
+/**
+ * @brief Returns the sample variance of the drop zones.
+ *
+ * @param stats Pointer to the convergence structure.
+ * @return The sample variance, or 0 with fewer than two balls.
+ */
+float convergence_variance(const convergence_struct *stats) {
+    if (stats->count < 2) return 0.0f;
+    return stats->m2 / (float)(stats->count - 1);
+}
+
+/**
+ * @brief Prints the statistics over USB, next to the binomial reference values.
+ *
+ * @param stats Pointer to the convergence structure.
+ */
+void convergence_print(const convergence_struct *stats) {
+    printf("Balls: %lu | Mean: %.3f (%.3f) | Variance: %.3f (%.3f) | Chi-square: %.2f (p = %.3f) | KS: %.3f + %.3f (<= %.3f) %s\n",
+           (unsigned long)stats->count,
+           stats->mean, PIN_LINES / 2.0f,
+           convergence_variance(stats), PIN_LINES / 4.0f,
+           stats->chi_square, stats->p_value,
+           stats->ks_distance, stats->ks_bound, stats->tolerance,
+           stats->converged ? "(converged)" : "");
+}
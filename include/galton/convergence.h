@@ -0,0 +1,55 @@
+#ifndef __CONVERGENCE_H__ // Caso já tenha sido declarada em algum outro lugar, não declare novamente.
+#define __CONVERGENCE_H__
+
+#include <stdint.h>
+#include "pico/stdlib.h"
+#include "include/galton/galton.h"
+
+#define CONVERGENCE_BINS (PIN_LINES + 1) // Drop zones, i.e. outcomes of Binomial(PIN_LINES, 0.5)
+
+// Default stop condition; each can be overridden with a compile definition
+#ifndef CONVERGENCE_TOLERANCE
+#define CONVERGENCE_TOLERANCE   (0.96f / (float)(1u << PIN_LINES)) // Largest accepted KS distance (plus DKW half-width); just under the outer bin mass, so an empty outer bin never passes
+#endif
+#ifndef CONVERGENCE_ALPHA
+#define CONVERGENCE_ALPHA       0.05f   // The DKW band holds with confidence 1 - alpha
+#endif
+#ifndef CONVERGENCE_MIN_BALLS
+#define CONVERGENCE_MIN_BALLS   100     // Never stop before this many balls landed; keeps 5+ expected balls in the outer bins
+#endif
+#ifndef CONVERGENCE_ACTION
+#define CONVERGENCE_ACTION      CONVERGENCE_STOP
+#endif
+
+typedef enum {
+    CONVERGENCE_STOP,       // Stop releasing balls once converged
+    CONVERGENCE_RESTART     // Clear the board and start a new run once converged
+} convergence_action;
+
+typedef struct {
+    // Stop condition
+    float tolerance;
+    float alpha;
+    uint16_t min_balls;
+    convergence_action action;
+
+    // Online statistics, updated for every landed ball
+    uint32_t count;
+    uint32_t bin_counts[CONVERGENCE_BINS];
+    float expected[CONVERGENCE_BINS];   // Binomial(PIN_LINES, 0.5) probabilities
+    float mean;
+    float m2;                           // Sum of squared deviations (Welford)
+    float chi_square;
+    float p_value;                      // Chi-square p-value with PIN_LINES degrees of freedom
+    float ks_distance;
+    float ks_bound;                     // DKW half-width at the current count
+    bool converged;
+} convergence_struct;
+
+void convergence_init(convergence_struct *stats, float tolerance, float alpha, uint16_t min_balls, convergence_action action);
+void convergence_reset(convergence_struct *stats);
+void convergence_add(convergence_struct *stats, uint8_t bin);
+float convergence_variance(const convergence_struct *stats);
+void convergence_print(const convergence_struct *stats);
+
+#endif
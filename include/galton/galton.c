@@ -1,4 +1,6 @@
 #include "galton.h"
+#include "physics.h"
+#include "convergence.h"
 #include "pico/rand.h"  // Library for generating random numbers
 #include "include/oled_display/oled_display.h" // Library for SSD1306 OLED display
 #include "include/oled_display/ssd1306_i2c.h" // Library for SSD1306 OLED display
@@ -6,9 +8,15 @@
 #include <math.h>
 
 char board[DISPLAY_WIDTH][DISPLAY_HEIGHT]; // '-' means empty space; 'b' means ball position; 'p' means pin position.
-const uint8_t board_center   = 39; // Center position of the board
-const uint8_t lines          = 4;  // Number of lines of pins
-uint8_t last_line_x_position[4];   // Stores the x-coordinates of the last line of pins
+const uint8_t board_center   = BOARD_CENTER; // Center position of the board
+const uint8_t lines          = PIN_LINES;    // Number of lines of pins
+uint8_t last_line_x_position[PIN_LINES];     // Stores the x-coordinates of the last line of pins
+static ball_struct balls[NUMBER_OF_BALLS];          // Array of ball structures
+static ball_struct *ball_pointers[NUMBER_OF_BALLS]; // Array of pointers to ball structures
+static convergence_struct stats;                    // Online statistics of the landed balls
+static uint32_t tick           = 0; // Physics ticks since the run started
+static uint16_t released_balls = 0; // Number of balls already released
+static uint16_t retired_balls  = 0; // Number of balls removed from full bins
 
 /**
  * @brief Generates a random decision for the Galton board simulation.
@@ -63,8 +71,8 @@ void draw_pin(int x, int y) {
  */
 void generate_board_pins() {
     const uint8_t initial_x   = board_center; // Initial x-coordinate for the pins
-    const uint8_t initial_y   = 25;           // Initial y-coordinate for the pins
-    const uint8_t gap         = 10;           // Gap between pins
+    const uint8_t initial_y   = PIN_INITIAL_Y; // Initial y-coordinate for the pins
+    const uint8_t gap         = PIN_GAP;       // Gap between pins
 
     // Draw pins on the display
     for (uint8_t i = 0; i < lines; i++) {
@@ -81,30 +89,37 @@ void generate_board_pins() {
 
 /**
  * @brief Draws a ball on the Galton board display.
- * This function updates the board matrix to represent the ball's position.
- * It also checks for collisions with pins and updates the ball's collision status.
+ * This function updates the board matrix to represent the ball's position,
+ * leaving pin pixels untouched. Collisions are handled by the physics step.
  * 
- * @param ball Pointer to the ball structure containing its position and collision status.
+ * @param ball Pointer to the ball structure containing its position.
  */
 void draw_ball(ball_struct *ball) {
-    if ((ball->x_position-2 < 0) || (ball->y_position-2 < 0) || (ball->x_position+2 >= DISPLAY_WIDTH) || (ball->y_position+2 >= DISPLAY_HEIGHT)) return;
-    ball->collision = false;
+    const int16_t x = FIXED_TO_INT(ball->x_position);
+    const int16_t y = FIXED_TO_INT(ball->y_position);
+
+    if ((x-2 < 0) || (y-2 < 0) || (x+2 >= DISPLAY_WIDTH) || (y+2 >= DISPLAY_HEIGHT)) return;
 
     for (int8_t i = -1; i < 2; i++) {
-        if (
-            board[ball->x_position+i][ball->y_position-2] == 'p' ||
-            board[ball->x_position+i][ball->y_position+2] == 'p' ||
-            board[ball->x_position-2][ball->y_position+i] == 'p' ||
-            board[ball->x_position+2][ball->y_position+i] == 'p' 
-        ) {
-            ball->collision = true;
-        } else {
-            board[ball->x_position+i][ball->y_position-2] = 'b';
-            board[ball->x_position+i][ball->y_position+2] = 'b';
-            board[ball->x_position-2][ball->y_position+i] = 'b';
-            board[ball->x_position+2][ball->y_position+i] = 'b';
-        }
+        if (board[x+i][y-2] != 'p') board[x+i][y-2] = 'b';
+        if (board[x+i][y+2] != 'p') board[x+i][y+2] = 'b';
+        if (board[x-2][y+i] != 'p') board[x-2][y+i] = 'b';
+        if (board[x+2][y+i] != 'p') board[x+2][y+i] = 'b';
+    }
+}
+
+/**
+ * @brief Determines the drop zone of a landed ball.
+ * The zones are delimited by the x-coordinates of the last line of pins.
+ * 
+ * @param x The x-coordinate of the ball.
+ * @return The drop zone below the last line of pins.
+ */
+drop_zone classify_drop_zone(int16_t x) {
+    for (uint8_t i = 0; i < PIN_LINES; i++) {
+        if (x < last_line_x_position[i]) return (drop_zone)(ZONE_1 + i);
     }
+    return (drop_zone)(ZONE_1 + PIN_LINES);
 }
 
 /**
@@ -117,10 +132,9 @@ void draw_ball(ball_struct *ball) {
  */
 void calculate_histogram(ball_struct *ball[NUMBER_OF_BALLS], uint16_t ball_count) {
     uint16_t zone_counts[5]     = {0,  0,  0,  0,   0}; // Counts for each zone
-    uint8_t zone_positions[5]   = {73, 84, 95, 106, 117}; // x-coordinates for histogram zones
 
     // Count balls in each zone
-    for (uint8_t i = 0; i < NUMBER_OF_BALLS; i++) {
+    for (uint16_t i = 0; i < NUMBER_OF_BALLS; i++) {
         switch(ball[i]->drop_location) {
             case ZONE_1:
                 zone_counts[0]++;
@@ -148,8 +162,10 @@ void calculate_histogram(ball_struct *ball[NUMBER_OF_BALLS], uint16_t ball_count
             zone_counts[i] = (uint16_t)round((float)(DISPLAY_HEIGHT + 40) * (float)zone_counts[i] / (float)ball_count);
             printf("Zone Count [%d]: %d \n", i, zone_counts[i]);
 
+            // Bars start right after the board, HISTOGRAM_BAR_PITCH columns apart
+            const uint8_t zone_position = BOARD_WIDTH + i*HISTOGRAM_BAR_PITCH;
             for (uint8_t k = 127; k > 127 - zone_counts[i]; k--) {
-                for (uint8_t j = zone_positions[i]; j < zone_positions[i] + 10; j++) {
+                for (uint8_t j = zone_position; j < zone_position + HISTOGRAM_BAR_PITCH - 1; j++) {
                     board[j][k] = 'h';
                 }   
             }
@@ -158,71 +174,226 @@ void calculate_histogram(ball_struct *ball[NUMBER_OF_BALLS], uint16_t ball_count
     printf("\n\n");
 }
 
+/**
+ * @brief Advances the simulation by one physics tick.
+ * Steps the released balls and assigns a drop zone to the ones that came to rest.
+ * Balls removed from the board are swapped to the front of the array, so the
+ * per-tick cost follows the balls still on the board rather than every ball dropped.
+ * 
+ * @param ball Array of pointers to ball structures.
+ * @param released_balls Number of balls already released.
+ * @param retired_balls Pointer to the number of balls at the front of `ball` that left the board.
+ * @param stats Statistics fed with every landed ball, or NULL.
+ * @return Number of balls that came to rest during this tick.
+ */
+uint16_t step_board(ball_struct *ball[NUMBER_OF_BALLS], uint16_t released_balls, uint16_t *retired_balls, convergence_struct *stats) {
+    uint16_t landed_balls = 0;
+
+    physics_step_balls(&ball[*retired_balls], released_balls - *retired_balls);
+
+    for (uint16_t i = *retired_balls; i < released_balls; i++) {
+        if (ball[i]->resting && ball[i]->drop_location == NONE) {
+            ball[i]->drop_location = classify_drop_zone(FIXED_TO_INT(ball[i]->x_position));
+            if (stats != NULL) convergence_add(stats, ball[i]->drop_location - ZONE_1);
+            landed_balls++;
+        }
+
+        if (!ball[i]->active && ball[i]->resting) {
+            ball_struct *retired = ball[*retired_balls];
+            ball[*retired_balls] = ball[i];
+            ball[i] = retired;
+            (*retired_balls)++;
+        }
+    }
+    return landed_balls;
+}
+
+/**
+ * @brief Starts a new run: every ball goes back to the release point and the statistics are cleared.
+ * 
+ * @param ball Array of pointers to ball structures.
+ */
+void restart_board(ball_struct *ball[NUMBER_OF_BALLS]) {
+    for (uint16_t i = 0; i < NUMBER_OF_BALLS; i++) {
+        physics_init_ball(ball[i]);
+    }
+    tick           = 0;
+    released_balls = 0;
+    retired_balls  = 0;
+    convergence_reset(&stats);
+}
+
 /**
  * @brief Updates the Galton board matrix with the current state of the simulation.
- * This function clears the board, generates pins, updates ball positions, and calculates
- * the histogram based on the ball distribution.
+ * This function clears the board, generates pins, advances the ball physics by the
+ * real time elapsed since the previous frame, and calculates the histogram based on
+ * the ball distribution. A new ball is released every BALL_RELEASE_TICKS ticks until
+ * the statistics converge; then the run stops or restarts once the board is still.
  * 
  * @param ball Array of pointers to ball structures.
  * @param ball_count Pointer to the total number of balls dropped.
+ * @param landed_balls Pointer to the number of balls that landed during this frame.
+ * @return true if balls are moving or waiting to be released, or the display changed.
  */
-void update_board_matrix(ball_struct *ball[NUMBER_OF_BALLS], uint16_t *ball_count) {
+bool update_board_matrix(ball_struct *ball[NUMBER_OF_BALLS], uint16_t *ball_count, uint16_t *landed_balls) {
+    static uint32_t printed_count = 0; // Landed balls at the last statistics printout
+
     clear_board();
     generate_board_pins();
-    
-    for (uint8_t i = 0; i < NUMBER_OF_BALLS; i++) {   
-        draw_ball(ball[i]);
-        if (ball[i]->collision) {
-            side random_side = generate_random_side();
-            
-            // Sort a random integer between 0 and 10 to be the horizontal shift
-            int8_t horizontal_shift = 5 + round(((float)get_rand_32()/UINT32_MAX)*10.0);
-            if (random_side == LEFT) horizontal_shift *= -1;
-            
-            ball[i]->x_position += horizontal_shift;
-            ball[i]->drop_location = NONE;
-            continue;
+
+    uint8_t steps = physics_pending_steps();
+    for (uint8_t s = 0; s < steps; s++, tick++) {
+        if (!stats.converged && released_balls < NUMBER_OF_BALLS && tick % BALL_RELEASE_TICKS == 0) {
+            ball[released_balls++]->active = true;
         }
-        
-        if (ball[i]->y_position < DISPLAY_HEIGHT - 1) {
-            ball[i]->y_position++;
-            ball[i]->drop_location = NONE;
+        (*landed_balls) += step_board(ball, released_balls, &retired_balls, &stats);
+    }
+
+    if (stats.count != printed_count) {
+        convergence_print(&stats);
+        printed_count = stats.count;
+    }
+
+    // Every released ball has landed: the run is over
+    if (stats.converged && stats.action == CONVERGENCE_RESTART && stats.count == released_balls) {
+        restart_board(ball);
+    }
+    const bool moving = stats.count < released_balls || (!stats.converged && released_balls < NUMBER_OF_BALLS);
+
+    for (uint16_t i = 0; i < released_balls; i++) {
+        if (ball[i]->active) draw_ball(ball[i]);
+        if (ball[i]->drop_location != NONE) (*ball_count)++;
+    }
+    calculate_histogram(ball, (*ball_count));
+
+    // Readout: KS distance plus DKW half-width (thousandths; stops at or below the tolerance), and OK once converged
+    char ks_bound_str[8];
+    snprintf(ks_bound_str, sizeof(ks_bound_str), "D%u", (uint)((stats.ks_distance + stats.ks_bound) * 1000.0f));
+    char *status[] = {ks_bound_str, "OK"};
+    const bool frame_sent = oled_display_update_board(board, (*ball_count), status, stats.converged ? 2 : 1);
+
+    return moving || frame_sent;
+}
+
+#ifdef GALTON_BENCHMARK
+#define BENCHMARK_TICKS         120     // Physics ticks timed for each ball count (one simulated second)
+#define BENCHMARK_MAX_TICKS     20000   // Give up waiting for the balls to settle after this many ticks
+#define BENCHMARK_BOARD_BALLS   200     // Balls per board copy, so the density does not change with the ball count
+
+/**
+ * @brief Fills the board copies with live balls at random positions between the walls.
+ * Ball i goes to copy i / BENCHMARK_BOARD_BALLS (see PHYSICS_BOARD_TILES).
+ *
+ * @param ball Array of pointers to ball structures.
+ * @param count Number of balls to place.
+ */
+void fill_board(ball_struct *ball[NUMBER_OF_BALLS], uint16_t count) {
+    const uint32_t width  = BOARD_RIGHT_WALL - BOARD_LEFT_WALL - 2*BALL_RADIUS;
+    const uint32_t height = DISPLAY_HEIGHT - 1 - BALL_RADIUS - BALL_SPAWN_Y;
+
+    for (uint16_t i = 0; i < count; i++) {
+        const fixed_t origin = INT_TO_FIXED((i / BENCHMARK_BOARD_BALLS) * BOARD_WIDTH);
+
+        physics_init_ball(ball[i]);
+        ball[i]->x_position = origin + INT_TO_FIXED(BOARD_LEFT_WALL + BALL_RADIUS) + (fixed_t)(((uint64_t)get_rand_32() * INT_TO_FIXED(width)) >> 32);
+        ball[i]->y_position = INT_TO_FIXED(BALL_SPAWN_Y) + (fixed_t)(((uint64_t)get_rand_32() * INT_TO_FIXED(height)) >> 32);
+        ball[i]->active     = true;
+    }
+}
+
+/**
+ * @brief Measures the cost of the ball physics and prints it over USB.
+ * For each ball count, BENCHMARK_BOARD_BALLS live balls are placed on each board copy,
+ * so the density stays the same and only the number of copies grows. The full physics
+ * tick and the ball-ball contact pass (grid broadphase) inside it are timed over
+ * BENCHMARK_TICKS ticks and reported per live ball; a constant cost per ball means the
+ * tick scales linearly. The balls are then stepped until all of them have come to
+ * rest, up to BENCHMARK_MAX_TICKS ticks. Counts that need more than PHYSICS_BOARD_TILES
+ * copies or NUMBER_OF_BALLS balls are skipped.
+ */
+void board_benchmark() {
+    const uint16_t counts[] = {200, 2000, 20000};
+
+    generate_board_pins(); // Fills last_line_x_position
+
+    for (uint16_t i = 0; i < NUMBER_OF_BALLS; i++) {
+        ball_pointers[i] = &balls[i];
+    }
+
+    for (uint8_t c = 0; c < count_of(counts); c++) {
+        const uint16_t boards = (counts[c] + BENCHMARK_BOARD_BALLS - 1) / BENCHMARK_BOARD_BALLS;
+        if (counts[c] > NUMBER_OF_BALLS || boards > PHYSICS_BOARD_TILES) {
+            printf("Benchmark %u balls: skipped (NUMBER_OF_BALLS = %u, PHYSICS_BOARD_TILES = %u)\n", counts[c], NUMBER_OF_BALLS, PHYSICS_BOARD_TILES);
             continue;
         }
-        
-        // Determine the drop location based on x_position
-        if (ball[i]->x_position < last_line_x_position[0]) ball[i]->drop_location = ZONE_1;
-        if (ball[i]->x_position >= last_line_x_position[0] && ball[i]->x_position < last_line_x_position[1]) ball[i]->drop_location = ZONE_2;
-        if (ball[i]->x_position >= last_line_x_position[1] && ball[i]->x_position < last_line_x_position[2]) ball[i]->drop_location = ZONE_3;
-        if (ball[i]->x_position >= last_line_x_position[2] && ball[i]->x_position < last_line_x_position[3]) ball[i]->drop_location = ZONE_4;
-        if (ball[i]->x_position >= last_line_x_position[3] && ball[i]->x_position < last_line_x_position[4]) ball[i]->drop_location = ZONE_5;
-        (*ball_count)++;
+
+        fill_board(ball_pointers, counts[c]);
+        uint16_t retired_balls = 0;
+        uint32_t live_balls    = 0;
+        physics_benchmark_contacts_us();
+        uint64_t start_us      = time_us_64();
+        for (uint16_t t = 0; t < BENCHMARK_TICKS; t++) {
+            live_balls += counts[c] - retired_balls;
+            step_board(ball_pointers, counts[c], &retired_balls, NULL);
+        }
+        const uint64_t tick_us     = time_us_64() - start_us;
+        const uint64_t contacts_us = physics_benchmark_contacts_us();
+
+        uint32_t ticks = BENCHMARK_TICKS;
+        uint16_t resting_balls = 0;
+        while (ticks < BENCHMARK_MAX_TICKS) {
+            resting_balls = 0;
+            for (uint16_t i = 0; i < counts[c]; i++) {
+                if (ball_pointers[i]->resting) resting_balls++;
+            }
+            if (resting_balls == counts[c]) break;
+
+            step_board(ball_pointers, counts[c], &retired_balls, NULL);
+            ticks++;
+        }
+
+        printf("Benchmark %u balls on %u boards: tick %llu us, contacts %llu us | per live ball: tick %llu ns, contacts %llu ns (%lu live on average) | %u/%u at rest after %lu ticks\n",
+               counts[c], boards,
+               (unsigned long long)(tick_us / BENCHMARK_TICKS), (unsigned long long)(contacts_us / BENCHMARK_TICKS),
+               (unsigned long long)(tick_us * 1000 / live_balls), (unsigned long long)(contacts_us * 1000 / live_balls),
+               (unsigned long)(live_balls / BENCHMARK_TICKS),
+               resting_balls, counts[c], (unsigned long)ticks);
     }
-    calculate_histogram(ball, (*ball_count));
-    oled_display_update_board(board, (*ball_count));
 }
+#endif
 
 /**
  * @brief Initializes the Galton board simulation.
- * This function sets up the initial state of the balls and continuously updates
- * the board matrix to simulate the Galton board.
+ * This function sets up the initial state of the balls and the statistics; the
+ * simulation itself advances one frame per call to board_update.
  */
 void board_init() {
-    ball_struct balls[NUMBER_OF_BALLS]; // Array of ball structures
-    ball_struct *ball_pointers[NUMBER_OF_BALLS]; // Array of pointers to ball structures
-
-    // Initialize balls with starting positions
-    for (uint8_t i = 0; i < NUMBER_OF_BALLS; i++) {
-        balls[i].x_position = board_center;
-        balls[i].y_position = 5 - 15*i;
-        balls[i].drop_location = NONE;
-        balls[i].collision = false;
+    // Initialize balls at the release point
+    for (uint16_t i = 0; i < NUMBER_OF_BALLS; i++) {
+        physics_init_ball(&balls[i]);
         ball_pointers[i] = &balls[i];
     }
+    convergence_init(&stats, CONVERGENCE_TOLERANCE, CONVERGENCE_ALPHA, CONVERGENCE_MIN_BALLS, CONVERGENCE_ACTION);
 
     clear_board();
-    while (true) {
-        uint16_t ball_count = 0;
-        update_board_matrix(ball_pointers, &ball_count);
-    }
-}
\ No newline at end of file
+}
+
+/**
+ * @brief Runs one frame of the Galton board simulation.
+ * 
+ * @param landed_balls Pointer to the number of balls that landed during this frame.
+ * @return true while the board is active (balls moving or the display changing).
+ */
+bool board_update(uint16_t *landed_balls) {
+    uint16_t ball_count = 0;
+
+    *landed_balls = 0;
+    return update_board_matrix(ball_pointers, &ball_count, landed_balls);
+}
+
+/**
+ * @brief Drops a new batch: clears the board and the statistics and starts releasing balls again.
+ */
+void board_restart() {
+    restart_board(ball_pointers);
+}
@@ -7,7 +7,32 @@
 #define DISPLAY_WIDTH 128
 #define DISPLAY_HEIGHT 64
 
-#define NUMBER_OF_BALLS 200
+#ifndef NUMBER_OF_BALLS
+#define NUMBER_OF_BALLS 2500 // Enough for the convergence stop (convergence.h) in nearly every run
+#endif
+
+// Board geometry (pixels)
+#define BOARD_CENTER    36  // x-coordinate of the first pin
+#define BOARD_WIDTH     73  // Board view spans x < BOARD_WIDTH; the histogram lives to its right (also the display layer split)
+#define HISTOGRAM_BAR_PITCH ((DISPLAY_WIDTH - BOARD_WIDTH) / (PIN_LINES + 1)) // One bar per drop zone right of the board, one column apart
+#define PIN_LINES       4   // Number of lines of pins
+#define PIN_INITIAL_Y   25  // y-coordinate of the first line of pins
+#define PIN_GAP         9   // Gap between pins
+#define PIN_RADIUS      1   // Collision radius of a pin
+#define BALL_RADIUS     2   // Collision radius of a ball
+#define BALL_SPAWN_Y    5   // y-coordinate where balls are released
+#define BALL_RELEASE_TICKS 30 // Physics ticks between two released balls; closer releases collide inside the pins
+#define BIN_TOP_Y       (PIN_INITIAL_Y + (PIN_LINES - 1)*PIN_GAP) // Bins start below the last line of pins
+#define BOARD_LEFT_WALL (BOARD_CENTER - PIN_LINES*PIN_GAP) // One pin gap left of the outer pins
+#define BOARD_RIGHT_WALL (BOARD_CENTER + PIN_LINES*PIN_GAP) // One pin gap right of the outer pins; must stay below BOARD_WIDTH
+
+// Fixed-point helpers (Q16.16) used by the ball integrator
+typedef int32_t fixed_t;
+#define FIXED_SHIFT         16
+#define FIXED_ONE           ((fixed_t)1 << FIXED_SHIFT)
+#define INT_TO_FIXED(x)     ((fixed_t)(x) * FIXED_ONE)
+#define FIXED_TO_INT(x)     ((int16_t)((x) >> FIXED_SHIFT))
+
 typedef enum {
     LEFT,
     RIGHT
@@ -23,12 +48,22 @@ typedef enum {
 } drop_zone;
 
 typedef struct {
-    int16_t x_position;
-    int16_t y_position;
+    fixed_t x_position;     // Q16.16 pixels
+    fixed_t y_position;     // Q16.16 pixels
+    fixed_t x_velocity;     // Q16.16 pixels per physics tick
+    fixed_t y_velocity;     // Q16.16 pixels per physics tick
     drop_zone drop_location;
-    bool collision;
+    bool collision;         // Hit a pin during the last physics tick
+    bool active;            // On the board (released and not removed from a full bin)
+    bool resting;           // Settled in a bin
+    uint8_t settle_ticks;   // Consecutive ticks spent supported (floor or resting ball) or nearly still
 } ball_struct;
 
 side generate_random_side();
 void board_init();
+bool board_update(uint16_t *landed_balls);
+void board_restart();
+#ifdef GALTON_BENCHMARK
+void board_benchmark();
+#endif
 #endif
\ No newline at end of file
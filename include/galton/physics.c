@@ -0,0 +1,555 @@
+#include <string.h>
+#include "physics.h"
+#include "pico/rand.h"  // Library for generating random numbers
+
+#ifdef GALTON_BENCHMARK
+static uint64_t benchmark_contacts_us = 0; // Time spent in resolve_ball_contacts, see physics_benchmark_contacts_us
+#endif
+
+// Contact found by the swept test between a moving ball and a pin
+typedef struct {
+    fixed_t time;       // Fraction of the step (0..FIXED_ONE) at which the contact happens
+    fixed_t x_position; // Ball center at the contact
+    fixed_t y_position;
+    fixed_t x_normal;   // Unit normal pointing from the pin to the ball
+    fixed_t y_normal;
+} contact_struct;
+
+/**
+ * @brief Computes the integer square root of a 64-bit value.
+ * Uses the bit-by-bit method, so it always finishes in at most 32 iterations.
+ *
+ * @param value The value whose square root is computed.
+ * @return The largest integer whose square does not exceed `value`.
+ */
+static uint32_t isqrt64(uint64_t value) {
+    uint64_t result = 0;
+    uint64_t bit    = (uint64_t)1 << 62;
+
+    while (bit > value) bit >>= 2;
+
+    while (bit != 0) {
+        if (value >= result + bit) {
+            value -= result + bit;
+            result = (result >> 1) + bit;
+        } else {
+            result >>= 1;
+        }
+        bit >>= 2;
+    }
+    return (uint32_t)result;
+}
+
+/**
+ * @brief Floor division for a positive divisor.
+ */
+static int32_t floor_div(int32_t a, int32_t b) {
+    if (a >= 0) return a / b;
+    return -((-a + b - 1) / b);
+}
+
+/**
+ * @brief Returns the x-coordinate where the board copy holding `x` starts.
+ * Always 0 unless PHYSICS_BOARD_TILES lays several boards side by side.
+ */
+static fixed_t tile_origin(fixed_t x) {
+#if PHYSICS_BOARD_TILES > 1
+    int32_t tile = (x >> FIXED_SHIFT) / BOARD_WIDTH;
+    if (tile < 0) tile = 0;
+    if (tile > PHYSICS_BOARD_TILES - 1) tile = PHYSICS_BOARD_TILES - 1;
+    return INT_TO_FIXED(tile * BOARD_WIDTH);
+#else
+    return 0;
+#endif
+}
+
+/**
+ * @brief Clamps a fixed-point value to the [-limit, limit] interval.
+ */
+static fixed_t clamp_fixed(fixed_t value, fixed_t limit) {
+    if (value > limit) return limit;
+    if (value < -limit) return -limit;
+    return value;
+}
+
+/**
+ * @brief Sweeps a ball along a displacement against a single pin.
+ * Solves |p + t*d - c| = R for the earliest t in [0, 1]. The math runs in Q8 so the
+ * 64-bit products cannot overflow for the speeds allowed by PHYSICS_MAX_SPEED.
+ *
+ * @param x Ball x-coordinate at the start of the step.
+ * @param y Ball y-coordinate at the start of the step.
+ * @param dx Displacement along x for the step.
+ * @param dy Displacement along y for the step.
+ * @param pin_x Pin x-coordinate.
+ * @param pin_y Pin y-coordinate.
+ * @param contact Filled with the contact data when a hit is found.
+ * @return true if the ball touches the pin during the step.
+ */
+static bool sweep_pin(fixed_t x, fixed_t y, fixed_t dx, fixed_t dy, fixed_t pin_x, fixed_t pin_y, contact_struct *contact) {
+    const int64_t radius   = (int64_t)(PIN_RADIUS + BALL_RADIUS) << 8;
+    const int64_t rel_x    = (x - pin_x) >> (FIXED_SHIFT - 8);
+    const int64_t rel_y    = (y - pin_y) >> (FIXED_SHIFT - 8);
+    const int64_t step_x   = dx >> (FIXED_SHIFT - 8);
+    const int64_t step_y   = dy >> (FIXED_SHIFT - 8);
+
+    const int64_t a = step_x*step_x + step_y*step_y;
+    const int64_t b = step_x*rel_x + step_y*rel_y;
+    const int64_t c = rel_x*rel_x + rel_y*rel_y - radius*radius;
+
+    // Moving away (or standing still) never produces a contact, even when overlapping
+    if (a == 0 || b >= 0) return false;
+
+    int64_t hit_x, hit_y;
+    if (c <= 0) {
+        // Already overlapping: push the ball back to the surface at t = 0
+        contact->time = 0;
+        hit_x = rel_x;
+        hit_y = rel_y;
+    } else {
+        const int64_t discriminant = b*b - a*c;
+        if (discriminant < 0) return false;
+
+        const int64_t t_numerator = -b - (int64_t)isqrt64((uint64_t)discriminant);
+        if (t_numerator > a) return false;
+
+        contact->time = (fixed_t)((t_numerator << FIXED_SHIFT) / a);
+        hit_x = rel_x + (step_x * contact->time >> FIXED_SHIFT);
+        hit_y = rel_y + (step_y * contact->time >> FIXED_SHIFT);
+    }
+
+    int64_t length = isqrt64((uint64_t)(hit_x*hit_x + hit_y*hit_y));
+    if (length == 0) {
+        hit_x  = 0;
+        hit_y  = -radius;
+        length = radius;
+    }
+
+    contact->x_normal   = (fixed_t)((hit_x << FIXED_SHIFT) / length);
+    contact->y_normal   = (fixed_t)((hit_y << FIXED_SHIFT) / length);
+    contact->x_position = pin_x + (fixed_t)(((int64_t)contact->x_normal * (radius << (FIXED_SHIFT - 8))) >> FIXED_SHIFT);
+    contact->y_position = pin_y + (fixed_t)(((int64_t)contact->y_normal * (radius << (FIXED_SHIFT - 8))) >> FIXED_SHIFT);
+    return true;
+}
+
+/**
+ * @brief Finds the earliest pin contact along a ball displacement.
+ * Only the pins whose lattice cell overlaps the swept segment are tested, so the
+ * cost is bounded by a handful of pins regardless of the board size.
+ *
+ * @param x Ball x-coordinate at the start of the step.
+ * @param y Ball y-coordinate at the start of the step.
+ * @param dx Displacement along x for the step.
+ * @param dy Displacement along y for the step.
+ * @param contact Filled with the earliest contact.
+ * @return true if any pin is hit during the step.
+ */
+static bool find_first_pin_contact(fixed_t x, fixed_t y, fixed_t dx, fixed_t dy, contact_struct *contact) {
+    const fixed_t reach   = INT_TO_FIXED(PIN_RADIUS + BALL_RADIUS);
+    const fixed_t gap     = INT_TO_FIXED(PIN_GAP);
+    const fixed_t origin  = tile_origin(x);
+    const fixed_t x_min   = MIN(x, x + dx) - reach - INT_TO_FIXED(BOARD_CENTER) - origin;
+    const fixed_t x_max   = MAX(x, x + dx) + reach - INT_TO_FIXED(BOARD_CENTER) - origin;
+    const fixed_t y_min   = MIN(y, y + dy) - reach - INT_TO_FIXED(PIN_INITIAL_Y);
+    const fixed_t y_max   = MAX(y, y + dy) + reach - INT_TO_FIXED(PIN_INITIAL_Y);
+
+    int32_t first_line = -floor_div(-y_min, gap); // ceil
+    int32_t last_line  = floor_div(y_max, gap);
+    if (first_line < 0) first_line = 0;
+    if (last_line > PIN_LINES - 1) last_line = PIN_LINES - 1;
+
+    bool found = false;
+    contact_struct candidate;
+
+    for (int32_t i = first_line; i <= last_line; i++) {
+        // Pin k of line i sits at BOARD_CENTER + (2k - i)*PIN_GAP
+        int32_t first_pin = -floor_div(-(x_min + i*gap), 2*gap);
+        int32_t last_pin  = floor_div(x_max + i*gap, 2*gap);
+        if (first_pin < 0) first_pin = 0;
+        if (last_pin > i) last_pin = i;
+
+        for (int32_t k = first_pin; k <= last_pin; k++) {
+            const fixed_t pin_x = origin + INT_TO_FIXED(BOARD_CENTER + (2*k - i)*PIN_GAP);
+            const fixed_t pin_y = INT_TO_FIXED(PIN_INITIAL_Y + i*PIN_GAP);
+
+            if (sweep_pin(x, y, dx, dy, pin_x, pin_y, &candidate) && (!found || candidate.time < contact->time)) {
+                *contact = candidate;
+                found = true;
+            }
+        }
+    }
+    return found;
+}
+
+/**
+ * @brief Applies the pin response to a ball velocity.
+ * Reflects the normal component with PHYSICS_PIN_RESTITUTION. On the first contact with
+ * a pin the tangential component is also damped by PHYSICS_PIN_FRICTION and a random
+ * tangential push picks the side, so every pin is one independent left/right decision
+ * that does not depend much on how the ball arrived; contacts while the ball is still
+ * rolling on the same pin only reflect it.
+ *
+ * @param ball Pointer to the ball structure.
+ * @param contact Contact returned by the swept test.
+ * @param first_contact true if the ball was not touching a pin on the previous tick.
+ */
+static void resolve_pin_contact(ball_struct *ball, const contact_struct *contact, bool first_contact) {
+    const int64_t normal_speed  = ((int64_t)ball->x_velocity * contact->x_normal + (int64_t)ball->y_velocity * contact->y_normal) >> FIXED_SHIFT;
+    const int64_t tangent_speed = ((int64_t)ball->x_velocity * -contact->y_normal + (int64_t)ball->y_velocity * contact->x_normal) >> FIXED_SHIFT;
+
+    int64_t new_normal  = normal_speed < 0 ? (-normal_speed * PHYSICS_PIN_RESTITUTION) >> FIXED_SHIFT : normal_speed;
+    int64_t new_tangent = tangent_speed;
+
+    if (first_contact) {
+        new_tangent = (tangent_speed * (FIXED_ONE - PHYSICS_PIN_FRICTION)) >> FIXED_SHIFT;
+
+        // Random kick magnitude in [PHYSICS_PIN_KICK/2, PHYSICS_PIN_KICK]
+        fixed_t kick = PHYSICS_PIN_KICK/2 + (fixed_t)(((uint64_t)get_rand_32() * (PHYSICS_PIN_KICK/2)) >> 32);
+        if (generate_random_side() == LEFT) kick = -kick;
+        new_tangent += kick;
+    }
+
+    ball->x_velocity = (fixed_t)((new_normal * contact->x_normal - new_tangent * contact->y_normal) >> FIXED_SHIFT);
+    ball->y_velocity = (fixed_t)((new_normal * contact->y_normal + new_tangent * contact->x_normal) >> FIXED_SHIFT);
+}
+
+/**
+ * @brief Keeps a ball inside the board walls and the bin dividers.
+ * The dividers hang below the pins of the last line, so each drop zone is its own
+ * bin; the side of a divider a ball belongs to is taken from its x-coordinate before the move.
+ *
+ * @param ball Pointer to the ball structure.
+ * @param previous_x Ball x-coordinate before the move.
+ */
+static void constrain_ball(ball_struct *ball, fixed_t previous_x) {
+    const fixed_t origin = tile_origin(previous_x);
+    const fixed_t x_min  = origin + INT_TO_FIXED(BOARD_LEFT_WALL + BALL_RADIUS);
+    const fixed_t x_max  = origin + INT_TO_FIXED(BOARD_RIGHT_WALL - BALL_RADIUS);
+    const fixed_t radius = INT_TO_FIXED(BALL_RADIUS);
+
+    if (ball->x_position < x_min) {
+        ball->x_position = x_min;
+        if (ball->x_velocity < 0) ball->x_velocity = (fixed_t)(((int64_t)-ball->x_velocity * PHYSICS_WALL_RESTITUTION) >> FIXED_SHIFT);
+    }
+    if (ball->x_position > x_max) {
+        ball->x_position = x_max;
+        if (ball->x_velocity > 0) ball->x_velocity = (fixed_t)(((int64_t)-ball->x_velocity * PHYSICS_WALL_RESTITUTION) >> FIXED_SHIFT);
+    }
+
+    if (ball->y_position <= INT_TO_FIXED(BIN_TOP_Y)) return;
+
+    for (uint8_t k = 0; k < PIN_LINES; k++) {
+        const fixed_t divider = origin + INT_TO_FIXED(BOARD_CENTER + (2*k - (PIN_LINES - 1))*PIN_GAP);
+
+        if (previous_x <= divider && ball->x_position > divider - radius) {
+            ball->x_position = divider - radius;
+            if (ball->x_velocity > 0) ball->x_velocity = (fixed_t)(((int64_t)-ball->x_velocity * PHYSICS_WALL_RESTITUTION) >> FIXED_SHIFT);
+        } else if (previous_x > divider && ball->x_position < divider + radius) {
+            ball->x_position = divider + radius;
+            if (ball->x_velocity < 0) ball->x_velocity = (fixed_t)(((int64_t)-ball->x_velocity * PHYSICS_WALL_RESTITUTION) >> FIXED_SHIFT);
+        }
+    }
+}
+
+/**
+ * @brief Advances a ball by one physics tick.
+ * Integrates gravity (semi-implicit Euler), sweeps the displacement against the pins
+ * so fast balls cannot tunnel through them, and bounces off the board walls and floor.
+ * At most PHYSICS_MAX_CONTACTS pin contacts are resolved per tick; any time left
+ * after that is dropped, keeping the per-ball cost bounded.
+ *
+ * @param ball Pointer to the ball structure.
+ * @return true if the ball is touching the floor at the end of the tick.
+ */
+static bool step_ball(ball_struct *ball) {
+    const fixed_t floor_y    = INT_TO_FIXED(DISPLAY_HEIGHT - 1 - BALL_RADIUS);
+    const fixed_t previous_x = ball->x_position;
+    const bool touching_pin  = ball->collision;
+
+    ball->collision  = false;
+    ball->y_velocity = clamp_fixed(ball->y_velocity + PHYSICS_GRAVITY, PHYSICS_MAX_SPEED);
+    ball->x_velocity = clamp_fixed(ball->x_velocity, PHYSICS_MAX_SPEED);
+
+    fixed_t remaining = FIXED_ONE;
+    for (uint8_t i = 0; i < PHYSICS_MAX_CONTACTS && remaining > 0; i++) {
+        const fixed_t dx = (fixed_t)(((int64_t)ball->x_velocity * remaining) >> FIXED_SHIFT);
+        const fixed_t dy = (fixed_t)(((int64_t)ball->y_velocity * remaining) >> FIXED_SHIFT);
+        contact_struct contact;
+
+        if (!find_first_pin_contact(ball->x_position, ball->y_position, dx, dy, &contact)) {
+            ball->x_position += dx;
+            ball->y_position += dy;
+            break;
+        }
+
+        ball->x_position = contact.x_position;
+        ball->y_position = contact.y_position;
+        resolve_pin_contact(ball, &contact, !touching_pin && !ball->collision);
+        ball->collision = true;
+        remaining -= (fixed_t)(((int64_t)remaining * contact.time) >> FIXED_SHIFT);
+    }
+
+    constrain_ball(ball, previous_x);
+
+    if (ball->y_position >= floor_y) {
+        ball->y_position = floor_y;
+        if (ball->y_velocity > 0) ball->y_velocity = (fixed_t)(((int64_t)-ball->y_velocity * PHYSICS_WALL_RESTITUTION) >> FIXED_SHIFT);
+        ball->x_velocity = (fixed_t)(((int64_t)ball->x_velocity * (FIXED_ONE - PHYSICS_FRICTION)) >> FIXED_SHIFT);
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Returns the broadphase grid cell that holds a ball.
+ * Cells are numbered column by column, so the balls of the first board copies only
+ * use the first cells (see resolve_ball_contacts).
+ */
+static uint16_t grid_cell(const ball_struct *ball) {
+    int32_t column = FIXED_TO_INT(ball->x_position) / PHYSICS_GRID_CELL;
+    int32_t row    = FIXED_TO_INT(ball->y_position) / PHYSICS_GRID_CELL;
+
+    if (column < 0) column = 0;
+    if (column > PHYSICS_GRID_COLUMNS - 1) column = PHYSICS_GRID_COLUMNS - 1;
+    if (row < 0) row = 0;
+    if (row > PHYSICS_GRID_ROWS - 1) row = PHYSICS_GRID_ROWS - 1;
+    return (uint16_t)(column * PHYSICS_GRID_ROWS + row);
+}
+
+/**
+ * @brief Resolves the overlap between two balls.
+ * Resting balls are treated as immovable, so the moving ball takes the whole
+ * correction and impulse; two moving balls share them equally.
+ *
+ * @param a Pointer to the first ball.
+ * @param b Pointer to the second ball.
+ * @param a_supported Set when `a` ends up lying on top of a resting `b`.
+ * @param b_supported Set when `b` ends up lying on top of a resting `a`.
+ */
+static void resolve_ball_contact(ball_struct *a, ball_struct *b, bool *a_supported, bool *b_supported) {
+    const fixed_t diameter = INT_TO_FIXED(2*BALL_RADIUS);
+    const int64_t rel_x    = a->x_position - b->x_position;
+    const int64_t rel_y    = a->y_position - b->y_position;
+    const int64_t distance_squared = rel_x*rel_x + rel_y*rel_y;
+
+    if (distance_squared >= (int64_t)diameter*diameter) return;
+
+    int64_t distance = isqrt64((uint64_t)distance_squared);
+    fixed_t normal_x = 0;
+    fixed_t normal_y = -FIXED_ONE;
+    if (distance > 0) {
+        normal_x = (fixed_t)((rel_x << FIXED_SHIFT) / distance);
+        normal_y = (fixed_t)((rel_y << FIXED_SHIFT) / distance);
+    }
+
+    // Share of the correction taken by each ball (Q16)
+    const fixed_t a_share = a->resting ? 0 : (b->resting ? FIXED_ONE : FIXED_ONE/2);
+    const fixed_t b_share = FIXED_ONE - a_share;
+
+    const int64_t depth = diameter - distance;
+    a->x_position += (fixed_t)((((depth * a_share) >> FIXED_SHIFT) * normal_x) >> FIXED_SHIFT);
+    a->y_position += (fixed_t)((((depth * a_share) >> FIXED_SHIFT) * normal_y) >> FIXED_SHIFT);
+    b->x_position -= (fixed_t)((((depth * b_share) >> FIXED_SHIFT) * normal_x) >> FIXED_SHIFT);
+    b->y_position -= (fixed_t)((((depth * b_share) >> FIXED_SHIFT) * normal_y) >> FIXED_SHIFT);
+
+    const int64_t normal_speed = ((int64_t)(a->x_velocity - b->x_velocity) * normal_x + (int64_t)(a->y_velocity - b->y_velocity) * normal_y) >> FIXED_SHIFT;
+    if (normal_speed < 0) {
+        const int64_t impulse = (normal_speed * (FIXED_ONE + PHYSICS_BALL_RESTITUTION)) >> FIXED_SHIFT;
+        const int64_t a_impulse = (impulse * a_share) >> FIXED_SHIFT;
+        const int64_t b_impulse = (impulse * b_share) >> FIXED_SHIFT;
+
+        a->x_velocity -= (fixed_t)((a_impulse * normal_x) >> FIXED_SHIFT);
+        a->y_velocity -= (fixed_t)((a_impulse * normal_y) >> FIXED_SHIFT);
+        b->x_velocity += (fixed_t)((b_impulse * normal_x) >> FIXED_SHIFT);
+        b->y_velocity += (fixed_t)((b_impulse * normal_y) >> FIXED_SHIFT);
+    }
+
+    // The normal points from b to a: a negative y means a lies on top of b
+    if (b->resting && normal_y < -FIXED_ONE/2) *a_supported = true;
+    if (a->resting && normal_y > FIXED_ONE/2) *b_supported = true;
+}
+
+/**
+ * @brief Resolves every ball-ball contact using a uniform grid broadphase.
+ * Balls are bucketed with a counting sort into cells as wide as a ball, so each
+ * ball is only tested against the balls of its 3x3 neighbourhood. Only the cells up to
+ * the last occupied one are cleared and summed, so the cost is O(n + occupied columns)
+ * as long as the ball density is bounded, which the bins guarantee.
+ *
+ * @param ball Array of pointers to ball structures.
+ * @param count Number of entries of `ball` to consider.
+ * @param supported Per-ball flag, set when the ball lies on a resting ball.
+ */
+static void resolve_ball_contacts(ball_struct *ball[], uint16_t count, bool supported[]) {
+    static uint16_t cell_start[PHYSICS_GRID_CELLS + 1];
+    static uint16_t cell_balls[NUMBER_OF_BALLS];
+    static uint16_t ball_cell[NUMBER_OF_BALLS];
+
+    uint16_t cells = 0; // One past the last occupied cell
+    for (uint16_t i = 0; i < count; i++) {
+        if (!ball[i]->active) continue;
+        ball_cell[i] = grid_cell(ball[i]);
+        if (ball_cell[i] >= cells) cells = ball_cell[i] + 1;
+    }
+
+    memset(cell_start, 0, (cells + 1) * sizeof(cell_start[0]));
+    for (uint16_t i = 0; i < count; i++) {
+        if (!ball[i]->active) continue;
+        cell_start[ball_cell[i] + 1]++;
+    }
+    for (uint16_t c = 0; c < cells; c++) {
+        cell_start[c + 1] += cell_start[c];
+    }
+
+    static uint16_t cell_fill[PHYSICS_GRID_CELLS];
+    memcpy(cell_fill, cell_start, cells * sizeof(cell_fill[0]));
+    for (uint16_t i = 0; i < count; i++) {
+        if (!ball[i]->active) continue;
+        cell_balls[cell_fill[ball_cell[i]]++] = i;
+    }
+
+    for (uint16_t i = 0; i < count; i++) {
+        if (!ball[i]->active || ball[i]->resting) continue;
+
+        const int16_t column = ball_cell[i] / PHYSICS_GRID_ROWS;
+        const int16_t row    = ball_cell[i] % PHYSICS_GRID_ROWS;
+        const fixed_t previous_x = ball[i]->x_position;
+
+        for (int16_t r = row - 1; r <= row + 1; r++) {
+            if (r < 0 || r >= PHYSICS_GRID_ROWS) continue;
+            for (int16_t c = column - 1; c <= column + 1; c++) {
+                if (c < 0 || c >= PHYSICS_GRID_COLUMNS) continue;
+
+                const uint16_t cell = c * PHYSICS_GRID_ROWS + r;
+                if (cell >= cells) continue;
+                for (uint16_t n = cell_start[cell]; n < cell_start[cell + 1]; n++) {
+                    const uint16_t j = cell_balls[n];
+
+                    // Each moving pair is handled once; resting balls never start a test
+                    if (j == i || (j < i && !ball[j]->resting)) continue;
+                    resolve_ball_contact(ball[i], ball[j], &supported[i], &supported[j]);
+                }
+            }
+        }
+        constrain_ball(ball[i], previous_x);
+    }
+}
+
+/**
+ * @brief Places a ball at the release point, not yet active.
+ * Balls leave the release point at PHYSICS_RELEASE_SPEED so consecutive releases do not overlap.
+ *
+ * @param ball Pointer to the ball structure.
+ */
+void physics_init_ball(ball_struct *ball) {
+    ball->x_position    = INT_TO_FIXED(BOARD_CENTER);
+    ball->y_position    = INT_TO_FIXED(BALL_SPAWN_Y);
+    ball->x_velocity    = 0;
+    ball->y_velocity    = PHYSICS_RELEASE_SPEED;
+    ball->drop_location = NONE;
+    ball->collision     = false;
+    ball->active        = false;
+    ball->resting       = false;
+    ball->settle_ticks  = 0;
+}
+
+/**
+ * @brief Advances every active ball by one physics tick.
+ * Moves the balls against pins, walls and floor, resolves ball-ball contacts, and
+ * lets slow balls that lie on the floor or on a resting ball inside a bin come to
+ * rest. A ball that stays supported or nearly still (slow, or pushed back to about where
+ * it started the tick) for PHYSICS_SETTLE_TICKS comes to rest as well, even if it is still
+ * jiggling (pressed between the floor and a resting ball) or wedged without support
+ * (between a divider and a resting ball, bouncing in place), so every
+ * pile settles in bounded time. A ball that settles above the bins (a full bin) is
+ * counted as resting but removed from the board so the pile cannot grow into the pins.
+ *
+ * @param ball Array of pointers to ball structures.
+ * @param count Number of entries of `ball` to advance.
+ */
+void physics_step_balls(ball_struct *ball[], uint16_t count) {
+    static bool supported[NUMBER_OF_BALLS];
+    static fixed_t start_x[NUMBER_OF_BALLS];
+    static fixed_t start_y[NUMBER_OF_BALLS];
+
+    for (uint16_t i = 0; i < count; i++) {
+        supported[i] = false;
+        if (!ball[i]->active || ball[i]->resting) continue;
+        start_x[i]   = ball[i]->x_position;
+        start_y[i]   = ball[i]->y_position;
+        supported[i] = step_ball(ball[i]);
+    }
+
+#ifdef GALTON_BENCHMARK
+    const uint64_t contacts_start_us = time_us_64();
+    resolve_ball_contacts(ball, count, supported);
+    benchmark_contacts_us += time_us_64() - contacts_start_us;
+#else
+    resolve_ball_contacts(ball, count, supported);
+#endif
+
+    for (uint16_t i = 0; i < count; i++) {
+        if (!ball[i]->active || ball[i]->resting) continue;
+
+        const fixed_t moved_x = ball[i]->x_position - start_x[i];
+        const fixed_t moved_y = ball[i]->y_position - start_y[i];
+        const bool slow = ball[i]->x_velocity <= PHYSICS_REST_SPEED && ball[i]->x_velocity >= -PHYSICS_REST_SPEED &&
+                          ball[i]->y_velocity <= PHYSICS_REST_SPEED && ball[i]->y_velocity >= -PHYSICS_REST_SPEED;
+        const bool still = moved_x <= PHYSICS_REST_SPEED && moved_x >= -PHYSICS_REST_SPEED &&
+                           moved_y <= PHYSICS_REST_SPEED && moved_y >= -PHYSICS_REST_SPEED;
+        if (!supported[i] && !slow && !still) {
+            ball[i]->settle_ticks = 0;
+            continue;
+        }
+        if (!(supported[i] && slow) && ++ball[i]->settle_ticks < PHYSICS_SETTLE_TICKS) continue;
+
+        ball[i]->x_velocity = 0;
+        ball[i]->y_velocity = 0;
+        ball[i]->resting    = true;
+        if (ball[i]->y_position <= INT_TO_FIXED(BIN_TOP_Y)) ball[i]->active = false;
+    }
+}
+
+#ifdef GALTON_BENCHMARK
+/**
+ * @brief Returns the time spent in the ball-ball contact pass (grid broadphase and
+ * contact resolution) since the previous call.
+ *
+ * @return Elapsed time in microseconds.
+ */
+uint64_t physics_benchmark_contacts_us() {
+    const uint64_t elapsed_us = benchmark_contacts_us;
+    benchmark_contacts_us = 0;
+    return elapsed_us;
+}
+#endif
+
+/**
+ * @brief Returns how many physics ticks should run for the current frame.
+ * Accumulates real elapsed time so the ball speed no longer depends on how fast
+ * the display is refreshed.
+ *
+ * @return Number of PHYSICS_TICK_US ticks elapsed since the previous call.
+ */
+uint8_t physics_pending_steps() {
+    static uint64_t last_time_us   = 0;
+    static uint32_t accumulator_us = 0;
+
+    uint64_t now = time_us_64();
+    if (last_time_us == 0) {
+        last_time_us = now;
+        return 1;
+    }
+
+    accumulator_us += (uint32_t)(now - last_time_us);
+    last_time_us = now;
+
+    uint32_t steps = accumulator_us / PHYSICS_TICK_US;
+    accumulator_us -= steps * PHYSICS_TICK_US;
+
+    if (steps > PHYSICS_MAX_STEPS_PER_FRAME) {
+        steps = PHYSICS_MAX_STEPS_PER_FRAME;
+        accumulator_us = 0;
+    }
+    return (uint8_t)steps;
+}
@@ -0,0 +1,44 @@
+#ifndef __PHYSICS_H__ // Caso já tenha sido declarada em algum outro lugar, não declare novamente.
+#define __PHYSICS_H__
+
+#include <stdint.h>
+#include "pico/stdlib.h"
+#include "include/galton/galton.h"
+
+#define PHYSICS_TICK_HZ             120                             // Fixed simulation rate, independent of the frame rate
+#define PHYSICS_TICK_US             (1000000 / PHYSICS_TICK_HZ)
+#define PHYSICS_MAX_STEPS_PER_FRAME 8                               // Drop time instead of spiralling when a frame runs late
+
+#define PHYSICS_GRAVITY             (INT_TO_FIXED(120) / (PHYSICS_TICK_HZ * PHYSICS_TICK_HZ)) // 120 px/s^2
+#define PHYSICS_MAX_SPEED           (2 * FIXED_ONE)                 // px/tick; kept below PIN_GAP so the sweep stays local
+#define PHYSICS_PIN_RESTITUTION     (FIXED_ONE * 5 / 100)
+#define PHYSICS_WALL_RESTITUTION    (FIXED_ONE * 30 / 100)
+#define PHYSICS_PIN_FRICTION        FIXED_ONE                       // Share of the tangential speed lost when a ball hits a pin
+#define PHYSICS_PIN_KICK            (FIXED_ONE * 24 / 100)          // Largest random push on a pin hit; carries the ball to a pin of the next line
+#define PHYSICS_MAX_CONTACTS        2                               // Pin contacts resolved per ball per tick
+#define PHYSICS_RELEASE_SPEED       (FIXED_ONE / 2)
+#define PHYSICS_BALL_RESTITUTION    (FIXED_ONE * 20 / 100)
+#define PHYSICS_FRICTION            (FIXED_ONE * 10 / 100)          // Share of the x velocity lost per tick on the floor
+#define PHYSICS_REST_SPEED          (FIXED_ONE / 16)                // Supported balls slower than this come to rest
+#define PHYSICS_SETTLE_TICKS        60                              // Supported or still balls come to rest after this long even if jiggling
+
+// Copies of the board laid side by side, each with its own pins, walls and bins. The host
+// benchmark uses them to keep the ball density constant while the ball count grows.
+#ifndef PHYSICS_BOARD_TILES
+#define PHYSICS_BOARD_TILES         1
+#endif
+
+// Uniform grid broadphase for ball-ball contacts; a cell is as wide as a ball
+#define PHYSICS_GRID_CELL           (2 * BALL_RADIUS)
+#define PHYSICS_GRID_COLUMNS        ((PHYSICS_BOARD_TILES * BOARD_WIDTH + PHYSICS_GRID_CELL - 1) / PHYSICS_GRID_CELL)
+#define PHYSICS_GRID_ROWS           ((DISPLAY_HEIGHT + PHYSICS_GRID_CELL - 1) / PHYSICS_GRID_CELL)
+#define PHYSICS_GRID_CELLS          (PHYSICS_GRID_COLUMNS * PHYSICS_GRID_ROWS)
+
+void physics_init_ball(ball_struct *ball);
+void physics_step_balls(ball_struct *ball[], uint16_t count);
+uint8_t physics_pending_steps();
+#ifdef GALTON_BENCHMARK
+uint64_t physics_benchmark_contacts_us();
+#endif
+
+#endif
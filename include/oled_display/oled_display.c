@@ -8,6 +8,32 @@ struct render_area frame_area = {
     end_page : ssd1306_n_pages - 1
 };
 
+// Pixels de cada camada, do tamanho exato da sua área
+static uint8_t board_pixels[OLED_HISTOGRAM_COLUMN * ssd1306_n_pages];
+static uint8_t histogram_pixels[(ssd1306_width - OLED_HISTOGRAM_COLUMN) * ssd1306_n_pages];
+static uint8_t hud_pixels[OLED_HUD_WIDTH * OLED_HUD_PAGES];
+
+// Camadas da tela, em ordem de sobreposição (a última fica por cima)
+static oled_layer layers[OLED_LAYER_COUNT] = {
+    [OLED_LAYER_BOARD] = {
+        area : {start_column : 0, end_column : OLED_HISTOGRAM_COLUMN - 1, start_page : 0, end_page : ssd1306_n_pages - 1},
+        period_us : OLED_BOARD_PERIOD_US,
+        pixels : board_pixels
+    },
+    [OLED_LAYER_HISTOGRAM] = {
+        area : {start_column : OLED_HISTOGRAM_COLUMN, end_column : ssd1306_width - 1, start_page : 0, end_page : ssd1306_n_pages - 1},
+        period_us : OLED_HISTOGRAM_PERIOD_US,
+        pixels : histogram_pixels
+    },
+    [OLED_LAYER_HUD] = {
+        area : {start_column : OLED_HUD_COLUMN, end_column : ssd1306_width - 1, start_page : 0, end_page : OLED_HUD_PAGES - 1},
+        period_us : OLED_HUD_PERIOD_US,
+        pixels : hud_pixels
+    },
+};
+
+static uint8_t screen[ssd1306_buffer_length]; // Conteúdo atual do display, composto a partir das camadas
+
 /**
  * Inicializa o display OLED da BitDogLab.
  */
@@ -22,6 +48,18 @@ void oled_display_init() {
     ssd1306_init();
     // Preparar área de renderização para o display (ssd1306_width pixels por ssd1306_n_pages páginas)
     calculate_render_area_buffer_length(&frame_area);
+
+    for (uint8_t i = 0; i < OLED_LAYER_COUNT; i++) {
+        calculate_render_area_buffer_length(&layers[i].area);
+        layers[i].force_flush = true;
+    }
+}
+
+/**
+ * Reaplica a taxa do I2C após uma mudança do clock do sistema (o clock dos periféricos deriva dele).
+ */
+void oled_display_update_clock() {
+    i2c_set_baudrate(i2c1, ssd1306_i2c_clock * 1000);
 }
 
 /**
@@ -42,6 +80,12 @@ void oled_display_write(char *text[], uint8_t n_lines, int16_t initial_y) {
         y += 8;
     }
     render_on_display(ssd, &frame_area);
+
+    // A tela inteira foi sobrescrita: as camadas precisam ser reenviadas
+    memcpy(screen, ssd, ssd1306_buffer_length);
+    for (uint8_t i = 0; i < OLED_LAYER_COUNT; i++) {
+        layers[i].force_flush = true;
+    }
 }
 
 void oled_display_draw_ball(uint8_t *ssd, int x, int y) {
@@ -62,23 +106,115 @@ void oled_display_draw_ball(uint8_t *ssd, int x, int y) {
     ssd1306_set_pixel(ssd, x+2, y-1, true);
 }
 
-void oled_display_update_board(char board[ssd1306_width][ssd1306_height], uint16_t ball_count) {
-    // Cria as variáveis para escrita do texto
-    static uint8_t ssd[ssd1306_buffer_length];
-    memset(ssd, 0, ssd1306_buffer_length);
+/**
+ * Indica se a posição (coluna, página) fica sob uma camada acima da camada informada.
+ */
+static bool oled_display_layer_covered(uint8_t layer, uint8_t column, uint8_t page) {
+    for (uint8_t i = layer + 1; i < OLED_LAYER_COUNT; i++) {
+        const struct render_area *area = &layers[i].area;
+        if (column >= area->start_column && column <= area->end_column && page >= area->start_page && page <= area->end_page) return true;
+    }
+    return false;
+}
+
+/**
+ * Indica se já passou o período de atualização da camada, marcando-a como atualizada.
+ */
+static bool oled_display_layer_due(uint8_t layer, uint64_t now) {
+    if (!layers[layer].force_flush && now - layers[layer].last_update_us < layers[layer].period_us) return false;
+
+    layers[layer].last_update_us = now;
+    return true;
+}
+
+/**
+ * Compõe a camada na tela e envia apenas a sua área de renderização, se algo mudou.
+ * As posições cobertas por camadas superiores mantêm o conteúdo delas.
+ * @return  true se a área da camada foi enviada ao display
+ */
+static bool oled_display_layer_flush(uint8_t layer) {
+    oled_layer *current = &layers[layer];
+    const uint8_t width = current->area.end_column - current->area.start_column + 1;
+    bool dirty = current->force_flush;
 
-    for (uint8_t i = 0; i < ssd1306_width; i++) {
-        for (uint8_t j = 0; j < ssd1306_height; j++) {
-            if(board[i][j] == '-') ssd1306_set_pixel(ssd, i, j, false);
-            else ssd1306_set_pixel(ssd, i, j, true);
+    for (uint8_t page = current->area.start_page; page <= current->area.end_page; page++) {
+        for (uint8_t column = current->area.start_column; column <= current->area.end_column; column++) {
+            if (oled_display_layer_covered(layer, column, page)) continue;
+
+            const int idx        = page * ssd1306_width + column;
+            const uint8_t pixels = current->pixels[(page - current->area.start_page) * width + (column - current->area.start_column)];
+            if (screen[idx] != pixels) {
+                screen[idx] = pixels;
+                dirty = true;
+            }
         }
     }
-    
-    char ball_count_str[6]; // Enough to hold "65535\0"
-    snprintf(ball_count_str, sizeof(ball_count_str), "%u", ball_count);
-    ssd1306_draw_string(ssd, 0, 0, ball_count_str);
 
-    render_on_display(ssd, &frame_area);
+    if (!dirty) return false;
+
+    render_region_on_display(screen, &current->area);
+    current->force_flush = false;
+    return true;
+}
+
+/**
+ * Copia a matriz do tabuleiro para os pixels de uma camada, dentro da área da camada.
+ * Cada byte guarda uma coluna de uma página (8 pixels, o bit 0 no topo), como no display.
+ */
+static void oled_display_layer_draw_board(uint8_t layer, char board[ssd1306_width][ssd1306_height]) {
+    const struct render_area *area = &layers[layer].area;
+    uint8_t *pixels = layers[layer].pixels;
+
+    for (uint8_t page = area->start_page; page <= area->end_page; page++) {
+        for (uint8_t i = area->start_column; i <= area->end_column; i++) {
+            uint8_t byte = 0;
+            for (uint8_t bit = 0; bit < ssd1306_page_height; bit++) {
+                if (board[i][page * ssd1306_page_height + bit] != '-') byte |= 1 << bit;
+            }
+            *pixels++ = byte;
+        }
+    }
+}
+
+/**
+ * Desenha o tabuleiro, o histograma e o contador de esferas, cada um em sua camada.
+ * Cada camada só é redesenhada após o seu período de atualização e só envia a sua
+ * área de renderização, e apenas se o conteúdo mudou.
+ * @param board         a matriz do tabuleiro ('-' é espaço vazio)
+ * @param ball_count    o número de esferas que já caíram
+ * @param status        as linhas de status a serem escritas abaixo do contador
+ * @param n_status      o número de linhas de status
+ * @return              true se alguma camada foi enviada ao display
+ */
+bool oled_display_update_board(char board[ssd1306_width][ssd1306_height], uint16_t ball_count, char *status[], uint8_t n_status) {
+    const uint64_t now = time_us_64();
+    bool sent = false;
+
+    if (oled_display_layer_due(OLED_LAYER_BOARD, now)) {
+        oled_display_layer_draw_board(OLED_LAYER_BOARD, board);
+        sent |= oled_display_layer_flush(OLED_LAYER_BOARD);
+    }
+
+    if (oled_display_layer_due(OLED_LAYER_HISTOGRAM, now)) {
+        oled_display_layer_draw_board(OLED_LAYER_HISTOGRAM, board);
+        sent |= oled_display_layer_flush(OLED_LAYER_HISTOGRAM);
+    }
+
+    if (oled_display_layer_due(OLED_LAYER_HUD, now)) {
+        oled_layer *hud = &layers[OLED_LAYER_HUD];
+        memset(hud->pixels, 0, sizeof(hud_pixels));
+
+        char ball_count_str[OLED_HUD_CHARS + 1]; // Enough to hold "65535\0"
+        snprintf(ball_count_str, sizeof(ball_count_str), "%u", ball_count);
+        ssd1306_draw_string_in_region(hud->pixels, &hud->area, 0, 0, ball_count_str);
+
+        for (uint8_t i = 0; i < n_status; i++) {
+            ssd1306_draw_string_in_region(hud->pixels, &hud->area, 0, 8 * (i + 1), status[i]);
+        }
+        sent |= oled_display_layer_flush(OLED_LAYER_HUD);
+    }
+
+    return sent;
 }
 
 /**
@@ -100,4 +236,37 @@ void oled_display_validate() {
     };
 
     oled_display_write(text, count_of(text), 8);
-}
\ No newline at end of file
+}
+
+#ifdef GALTON_BENCHMARK
+/**
+ * Mede o tempo de envio de um bitmap completo ao display e imprime pela USB,
+ * comparando o envio atual (uma transferência) com o antigo (uma transferência por byte).
+ * O envio antigo transmite ssd1306_buffer_length vezes o buffer inteiro e leva dezenas de segundos.
+ */
+void oled_display_benchmark() {
+    static ssd1306_t ssd_bm;
+    static uint8_t bitmap[ssd1306_buffer_length];
+
+    for (uint i = 0; i < ssd1306_buffer_length; i++) {
+        bitmap[i] = (i & 1) ? 0xAA : 0x55;
+    }
+
+    ssd1306_init_bm(&ssd_bm, ssd1306_width, ssd1306_height, false, ssd1306_i2c_address, i2c1);
+    ssd1306_config(&ssd_bm);
+
+    uint64_t start_us = time_us_64();
+    ssd1306_draw_bitmap(&ssd_bm, bitmap);
+    uint64_t single_us = time_us_64() - start_us;
+
+    start_us = time_us_64();
+    ssd1306_draw_bitmap_per_byte(&ssd_bm, bitmap);
+    uint64_t per_byte_us = time_us_64() - start_us;
+
+    printf("Bitmap upload: %llu us (1 transfer), per-byte upload: %llu us (%u transfers)\n",
+           (unsigned long long)single_us, (unsigned long long)per_byte_us, ssd1306_buffer_length);
+
+    // ssd1306_config usa endereçamento vertical; restaura a configuração usada pelo tabuleiro
+    ssd1306_init();
+}
+#endif
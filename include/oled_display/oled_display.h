@@ -10,13 +10,43 @@
 #include "include/pinout.h"
 #include "include/oled_display/ssd1306.h"       // Biblioteca para controle do display OLED da BitDogLab.
 #include "include/oled_display/ssd1306_i2c.h"   // Biblioteca para controle do display OLED da BitDogLab.
+#include "include/galton/galton.h"              // Geometria do tabuleiro (BOARD_WIDTH).
+
+// Camadas da tela: tabuleiro (x < OLED_HISTOGRAM_COLUMN), histograma e contador (HUD) no canto superior direito
+#define OLED_HISTOGRAM_COLUMN       BOARD_WIDTH // Primeira coluna do histograma, definida pela geometria do tabuleiro
+#define OLED_HUD_CHARS              5       // Texto mais largo do HUD: o contador de esferas, até "65535" (uint16_t)
+#define OLED_HUD_WIDTH              (OLED_HUD_CHARS * 8) // Caracteres de 8 pixels
+#define OLED_HUD_COLUMN             (ssd1306_width - OLED_HUD_WIDTH) // Sobre o topo do histograma; à esquerda cobriria a queda das esferas
+#define OLED_HUD_PAGES              3       // Contador e duas linhas de status
+#define OLED_BOARD_PERIOD_US        0       // Esferas: a cada quadro
+#define OLED_HISTOGRAM_PERIOD_US    250000
+#define OLED_HUD_PERIOD_US          100000
+
+typedef enum {
+    OLED_LAYER_BOARD,
+    OLED_LAYER_HISTOGRAM,
+    OLED_LAYER_HUD,
+    OLED_LAYER_COUNT
+} oled_layer_id;
+
+typedef struct {
+    struct render_area area;                // Região da tela ocupada pela camada
+    uint32_t period_us;                     // Intervalo mínimo entre dois redesenhos
+    uint64_t last_update_us;
+    bool force_flush;                       // Reenviar mesmo sem mudanças (início ou tela sobrescrita)
+    uint8_t *pixels;                        // Conteúdo da camada, apenas a sua área (página a página, largura da área)
+} oled_layer;
 
 void oled_display_init();
+void oled_display_update_clock();
 void oled_display_clear();
 void oled_display_write(char *text[], uint8_t n_lines, int16_t initial_y);
 void oled_display_draw_ball(uint8_t *ssd, int x, int y);
 void oled_display_draw_board(int ball_x, int ball_y);
-void oled_display_update_board(char board[ssd1306_width][ssd1306_height], uint16_t ball_count);
+bool oled_display_update_board(char board[ssd1306_width][ssd1306_height], uint16_t ball_count, char *status[], uint8_t n_status);
 void oled_display_validate();
+#ifdef GALTON_BENCHMARK
+void oled_display_benchmark();
+#endif
 
 #endif
\ No newline at end of file
@@ -6,12 +6,17 @@ extern void ssd1306_send_buffer(uint8_t ssd[], int buffer_length);
 extern void ssd1306_init();
 extern void ssd1306_scroll(bool set);
 extern void render_on_display(uint8_t *ssd, struct render_area *area);
+extern void render_region_on_display(uint8_t *ssd, struct render_area *area);
 extern void ssd1306_set_pixel(uint8_t *ssd, int x, int y, bool set);
 extern void ssd1306_draw_line(uint8_t *ssd, int x_0, int y_0, int x_1, int y_1, bool set);
 extern void ssd1306_draw_char(uint8_t *ssd, int16_t x, int16_t y, uint8_t character);
 extern void ssd1306_draw_string(uint8_t *ssd, int16_t x, int16_t y, char *string);
+extern void ssd1306_draw_string_in_region(uint8_t *ssd, struct render_area *area, int16_t x, int16_t y, char *string);
 extern void ssd1306_command(ssd1306_t *ssd, uint8_t command);
 extern void ssd1306_config(ssd1306_t *ssd);
 extern void ssd1306_init_bm(ssd1306_t *ssd, uint8_t width, uint8_t height, bool external_vcc, uint8_t address, i2c_inst_t *i2c);
 extern void ssd1306_send_data(ssd1306_t *ssd);
-extern void ssd1306_draw_bitmap(ssd1306_t *ssd, const uint8_t *bitmap);
\ No newline at end of file
+extern void ssd1306_draw_bitmap(ssd1306_t *ssd, const uint8_t *bitmap);
+#ifdef GALTON_BENCHMARK
+extern void ssd1306_draw_bitmap_per_byte(ssd1306_t *ssd, const uint8_t *bitmap);
+#endif
\ No newline at end of file
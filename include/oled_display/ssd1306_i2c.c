@@ -26,16 +26,16 @@ void ssd1306_send_command_list(uint8_t *ssd, int number) {
     }
 }
 
-// Copia buffer de referência num novo buffer, a fim de adicionar o byte de controle desde o início
+// Copia buffer de referência num buffer estático, a fim de adicionar o byte de controle desde o início
 void ssd1306_send_buffer(uint8_t ssd[], int buffer_length) {
-    uint8_t *temp_buffer = malloc(buffer_length + 1);
+    static uint8_t temp_buffer[ssd1306_buffer_length + 1];
+
+    assert(buffer_length >= 0 && buffer_length <= (int)ssd1306_buffer_length);
 
     temp_buffer[0] = 0x40;
     memcpy(temp_buffer + 1, ssd, buffer_length);
 
     i2c_write_blocking(i2c1, ssd1306_i2c_address, temp_buffer, buffer_length + 1, false);
-
-    free(temp_buffer);
 }
 
 // Cria a lista de comandos (com base nos endereços definidos em ssd1306_i2c.h) para a inicialização do display
@@ -85,6 +85,27 @@ void render_on_display(uint8_t *ssd, struct render_area *area) {
     ssd1306_send_buffer(ssd, area->buffer_length);
 }
 
+// Atualiza apenas uma área de renderização, lendo-a de um buffer do tamanho da tela inteira
+void render_region_on_display(uint8_t *ssd, struct render_area *area) {
+    static uint8_t temp_buffer[ssd1306_buffer_length + 1];
+    const int width = area->end_column - area->start_column + 1;
+    int length = 1;
+
+    uint8_t commands[] = {
+        ssd1306_set_column_address, area->start_column, area->end_column,
+        ssd1306_set_page_address, area->start_page, area->end_page
+    };
+    ssd1306_send_command_list(commands, count_of(commands));
+
+    temp_buffer[0] = 0x40;
+    for (int page = area->start_page; page <= area->end_page; page++) {
+        memcpy(temp_buffer + length, ssd + page * ssd1306_width + area->start_column, width);
+        length += width;
+    }
+
+    i2c_write_blocking(i2c1, ssd1306_i2c_address, temp_buffer, length, false);
+}
+
 // Determina o pixel a ser aceso (no display) de acordo com a coordenada fornecida
 void ssd1306_set_pixel(uint8_t *ssd, int x, int y, bool set) {
     assert(x >= 0 && x < ssd1306_width && y >= 0 && y < ssd1306_height);
@@ -174,6 +195,21 @@ void ssd1306_draw_string(uint8_t *ssd, int16_t x, int16_t y, char *string) {
     }
 }
 
+// Desenha uma string em um buffer que guarda apenas a área informada (x e y relativos à área)
+void ssd1306_draw_string_in_region(uint8_t *ssd, struct render_area *area, int16_t x, int16_t y, char *string) {
+    const int width = area->end_column - area->start_column + 1;
+    const int pages = area->end_page - area->start_page + 1;
+    if (x < 0 || y < 0 || y / 8 >= pages) {
+        return;
+    }
+
+    while (*string && x <= width - 8) {
+        int idx = ssd1306_get_font(toupper(*string++));
+        memcpy(ssd + (y / 8) * width + x, font + idx * 8, 8);
+        x += 8;
+    }
+}
+
 // Comando de configuração com base na estrutura ssd1306_t
 void ssd1306_command(ssd1306_t *ssd, uint8_t command) {
   ssd->port_buffer[1] = command;
@@ -218,7 +254,8 @@ void ssd1306_init_bm(ssd1306_t *ssd, uint8_t width, uint8_t height, bool externa
     ssd->address = address;
     ssd->i2c_port = i2c;
     ssd->bufsize = ssd->pages * ssd->width + 1;
-    ssd->ram_buffer = calloc(ssd->bufsize, sizeof(uint8_t));
+    assert(ssd->bufsize <= sizeof(ssd->ram_buffer));
+    memset(ssd->ram_buffer, 0, sizeof(ssd->ram_buffer));
     ssd->ram_buffer[0] = 0x40;
     ssd->port_buffer[0] = 0x80;
 }
@@ -235,11 +272,20 @@ void ssd1306_send_data(ssd1306_t *ssd) {
     ssd->i2c_port, ssd->address, ssd->ram_buffer, ssd->bufsize, false );
 }
 
-// Desenha o bitmap (a ser fornecido em display_oled.c) no display
+// Desenha o bitmap (a ser fornecido em display_oled.c) no display, com uma única transferência
 void ssd1306_draw_bitmap(ssd1306_t *ssd, const uint8_t *bitmap) {
+    memcpy(ssd->ram_buffer + 1, bitmap, ssd->bufsize - 1);
+
+    ssd1306_send_data(ssd);
+}
+
+#ifdef GALTON_BENCHMARK
+// Envio antigo do bitmap, mantido só para comparação no benchmark: uma transferência completa por byte
+void ssd1306_draw_bitmap_per_byte(ssd1306_t *ssd, const uint8_t *bitmap) {
     for (int i = 0; i < ssd->bufsize - 1; i++) {
         ssd->ram_buffer[i + 1] = bitmap[i];
 
         ssd1306_send_data(ssd);
     }
-}
\ No newline at end of file
+}
+#endif
\ No newline at end of file
@@ -60,7 +60,7 @@ typedef struct {
   uint8_t width, height, pages, address;
   i2c_inst_t * i2c_port;
   bool external_vcc;
-  uint8_t *ram_buffer;
+  uint8_t ram_buffer[ssd1306_buffer_length + 1]; // Byte de controle + ssd1306_n_pages páginas de ssd1306_width colunas
   size_t bufsize;
   uint8_t port_buffer[2];
 } ssd1306_t;
@@ -0,0 +1,149 @@
+#include "power.h"
+#include <stdio.h>
+#include "hardware/clocks.h"
+#include "hardware/gpio.h"
+#include "hardware/sync.h"
+#include "include/pinout.h"
+#include "include/oled_display/oled_display.h"
+
+static volatile bool wake_request  = false; // Set by button A
+static volatile bool batch_request = false; // Set by button B
+
+static power_policy_struct policy; // Mode and inactivity count, see power_policy.c
+
+// Accounting since the last report
+static uint64_t active_run_us = 0;  // Time spent working at POWER_ACTIVE_CLOCK_KHZ
+static uint64_t idle_run_us   = 0;  // Time spent working at POWER_IDLE_CLOCK_KHZ
+static uint64_t waiting_us    = 0;  // Time spent waiting between frames
+static uint32_t report_balls  = 0;  // Balls landed since the last report
+static uint64_t last_report_us = 0;
+
+/**
+ * @brief Handles button A (wake up) and button B (drop a new batch).
+ * Runs in interrupt context: it only sets flags and signals an event so the main
+ * loop leaves its wait right away.
+ */
+static void power_button_callback(uint gpio, uint32_t events) {
+    static uint32_t last_a_press_us = 0;
+    static uint32_t last_b_press_us = 0;
+
+    // Each button has its own debounce window, so pressing one never hides the other
+    uint32_t *last_press_us = gpio == B_BUTTON_PIN ? &last_b_press_us : &last_a_press_us;
+    uint32_t now = time_us_32();
+    if (now - *last_press_us < POWER_DEBOUNCE_US) return;
+    *last_press_us = now;
+
+    if (gpio == B_BUTTON_PIN) batch_request = true;
+    wake_request = true;
+    __sev();
+}
+
+/**
+ * @brief Switches the system clock and reapplies the I2C rate derived from it.
+ */
+static void power_set_clock(uint32_t clock_khz) {
+    set_sys_clock_khz(clock_khz, false);
+    oled_display_update_clock();
+}
+
+/**
+ * @brief Prints the duty cycle and the estimated energy per 1000 balls over USB.
+ */
+static void power_print_report() {
+    const uint64_t total_us = active_run_us + idle_run_us + waiting_us;
+    if (total_us == 0) return;
+
+    const float energy_mj = (POWER_ACTIVE_RUN_MA * active_run_us + POWER_IDLE_RUN_MA * idle_run_us + POWER_SLEEP_MA * waiting_us)
+                            * POWER_SUPPLY_MV / 1e9f;
+
+    printf("Power: %s | Duty cycle: %.1f%% | Energy: %.1f mJ", policy.mode == POWER_ACTIVE ? "active" : "idle",
+           100.0f * (active_run_us + idle_run_us) / total_us, energy_mj);
+    if (report_balls > 0) printf(" | %.1f mJ per 1000 balls", energy_mj * 1000.0f / report_balls);
+    printf("\n");
+
+    active_run_us = 0;
+    idle_run_us   = 0;
+    waiting_us    = 0;
+    report_balls  = 0;
+}
+
+/**
+ * @brief Sets up the buttons as wake-up sources and starts in active mode.
+ */
+void power_init() {
+    gpio_init(A_BUTTON_PIN);
+    gpio_set_dir(A_BUTTON_PIN, GPIO_IN);
+    gpio_pull_up(A_BUTTON_PIN);
+
+    gpio_init(B_BUTTON_PIN);
+    gpio_set_dir(B_BUTTON_PIN, GPIO_IN);
+    gpio_pull_up(B_BUTTON_PIN);
+
+    gpio_set_irq_enabled_with_callback(A_BUTTON_PIN, GPIO_IRQ_EDGE_FALL, true, &power_button_callback);
+    gpio_set_irq_enabled(B_BUTTON_PIN, GPIO_IRQ_EDGE_FALL, true);
+
+    power_policy_init(&policy);
+    power_set_clock(POWER_ACTIVE_CLOCK_KHZ);
+    last_report_us = time_us_64();
+}
+
+/**
+ * @brief Reads and clears a request set by the button interrupt.
+ * Interrupts stay disabled in between, so a press that lands after the read is not cleared with it.
+ *
+ * @param request The request flag.
+ * @return Whether the request was set.
+ */
+static bool take_request(volatile bool *request) {
+    const uint32_t status = save_and_disable_interrupts();
+    const bool requested = *request;
+    *request = false;
+    restore_interrupts(status);
+    return requested;
+}
+
+/**
+ * @brief Returns whether button B asked for a new batch, clearing the request.
+ */
+bool power_take_batch_request() {
+    return take_request(&batch_request);
+}
+
+/**
+ * @brief Closes a frame: accounts its cost, picks the power mode and waits for the next frame.
+ * While idle, the clock is lowered and the wait lasts POWER_IDLE_FRAME_US, but any
+ * button press ends it immediately.
+ *
+ * @param board_active Whether balls are moving or the display changed during the frame.
+ * @param landed_balls Number of balls that landed during the frame.
+ * @param frame_start_us Time at which the frame started.
+ */
+void power_end_frame(bool board_active, uint16_t landed_balls, uint64_t frame_start_us) {
+    const uint64_t now = time_us_64();
+
+    if (policy.mode == POWER_ACTIVE) active_run_us += now - frame_start_us;
+    else idle_run_us += now - frame_start_us;
+    report_balls += landed_balls;
+
+    const bool wake = take_request(&wake_request);
+
+    const power_mode previous = policy.mode;
+    const power_mode next     = power_policy_step(&policy, board_active, wake);
+    if (next != previous) {
+        power_set_clock(next == POWER_ACTIVE ? POWER_ACTIVE_CLOCK_KHZ : POWER_IDLE_CLOCK_KHZ);
+        printf("Power: %s\n", next == POWER_ACTIVE ? "active" : "idle");
+    }
+
+    if (now - last_report_us >= POWER_REPORT_INTERVAL_US) {
+        power_print_report();
+        last_report_us = now;
+    }
+
+    // Wait for the next frame; in idle mode a button press ends the wait early
+    const uint64_t waiting_start_us = time_us_64();
+    const absolute_time_t deadline = from_us_since_boot(frame_start_us + (policy.mode == POWER_ACTIVE ? POWER_ACTIVE_FRAME_US : POWER_IDLE_FRAME_US));
+    while (!time_reached(deadline) && !(policy.mode == POWER_IDLE && wake_request)) {
+        best_effort_wfe_or_timeout(deadline);
+    }
+    waiting_us += time_us_64() - waiting_start_us;
+}
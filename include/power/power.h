@@ -0,0 +1,25 @@
+#ifndef __POWER_H__ // Caso já tenha sido declarada em algum outro lugar, não declare novamente.
+#define __POWER_H__
+
+#include <stdint.h>
+#include "pico/stdlib.h"
+#include "power_policy.h"
+
+#define POWER_ACTIVE_CLOCK_KHZ      125000  // System clock while balls are moving
+#define POWER_IDLE_CLOCK_KHZ        48000   // Lowest clock that keeps USB stdio working
+#define POWER_ACTIVE_FRAME_US       33333   // Frame period while active (30 fps)
+#define POWER_IDLE_FRAME_US         500000  // Wake-up period while idle
+#define POWER_DEBOUNCE_US           200000  // Button debounce window
+#define POWER_REPORT_INTERVAL_US    10000000
+
+// Rough supply model used for the energy estimate; adjust for the actual board
+#define POWER_SUPPLY_MV             3300
+#define POWER_ACTIVE_RUN_MA         25.0f   // Running at POWER_ACTIVE_CLOCK_KHZ
+#define POWER_IDLE_RUN_MA           10.0f   // Running at POWER_IDLE_CLOCK_KHZ
+#define POWER_SLEEP_MA              4.0f    // Waiting for an event between frames
+
+void power_init();
+bool power_take_batch_request();
+void power_end_frame(bool board_active, uint16_t landed_balls, uint64_t frame_start_us);
+
+#endif
@@ -0,0 +1,44 @@
+#include "power_policy.h"
+
+/**
+ * @brief Chooses the power mode for the next frame.
+ * Pure function of the scheduler state, so its decisions can be replayed off target.
+ *
+ * @param current The current power mode.
+ * @param inactive_frames Number of consecutive frames with no moving ball and no display change.
+ * @param wake_request Whether a button asked to wake up.
+ * @return The power mode for the next frame.
+ */
+power_mode power_decide(power_mode current, uint16_t inactive_frames, bool wake_request) {
+    if (wake_request || inactive_frames == 0) return POWER_ACTIVE;
+    if (inactive_frames >= POWER_IDLE_AFTER_FRAMES) return POWER_IDLE;
+    return current;
+}
+
+/**
+ * @brief Starts the scheduler in active mode.
+ *
+ * @param policy Pointer to the scheduler state.
+ */
+void power_policy_init(power_policy_struct *policy) {
+    policy->mode            = POWER_ACTIVE;
+    policy->inactive_frames = 0;
+}
+
+/**
+ * @brief Feeds one frame to the scheduler and returns the power mode for the next one.
+ * A wake request counts as activity, so the board stays awake for at least
+ * POWER_IDLE_AFTER_FRAMES frames after a button press.
+ *
+ * @param policy Pointer to the scheduler state.
+ * @param board_active Whether balls were moving or the display changed during the frame.
+ * @param wake_request Whether a button asked to wake up during the frame.
+ * @return The power mode for the next frame.
+ */
+power_mode power_policy_step(power_policy_struct *policy, bool board_active, bool wake_request) {
+    if (board_active || wake_request) policy->inactive_frames = 0;
+    else if (policy->inactive_frames < UINT16_MAX) policy->inactive_frames++;
+
+    policy->mode = power_decide(policy->mode, policy->inactive_frames, wake_request);
+    return policy->mode;
+}
@@ -0,0 +1,25 @@
+#ifndef __POWER_POLICY_H__ // Caso já tenha sido declarada em algum outro lugar, não declare novamente.
+#define __POWER_POLICY_H__
+
+// Scheduler decisions only: no SDK dependency, so the policy also builds on the host (host/power_trace.c)
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define POWER_IDLE_AFTER_FRAMES     30      // Consecutive inactive frames before going idle
+
+typedef enum {
+    POWER_ACTIVE,
+    POWER_IDLE
+} power_mode;
+
+typedef struct {
+    power_mode mode;
+    uint16_t inactive_frames;   // Consecutive frames with no moving ball and no display change
+} power_policy_struct;
+
+power_mode power_decide(power_mode current, uint16_t inactive_frames, bool wake_request);
+void power_policy_init(power_policy_struct *policy);
+power_mode power_policy_step(power_policy_struct *policy, bool board_active, bool wake_request);
+
+#endif
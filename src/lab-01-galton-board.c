@@ -5,14 +5,26 @@
 
 #include "include/oled_display/oled_display.h" // Biblioteca para uso do SSD1306, display OLED.
 #include "include/galton/galton.h"             // Biblioteca com funções relacionadas ao projeto da Galton Board
+#include "include/power/power.h"               // Biblioteca para o modo de baixo consumo guiado pela simulação
 
 int main() {
     stdio_init_all();
     oled_display_init();
 
+#ifdef GALTON_BENCHMARK
+    oled_display_benchmark();
+    board_benchmark();
+#endif
+
     board_init();
+    power_init();
     while (true) {
+        uint64_t frame_start_us = time_us_64();
+        uint16_t landed_balls   = 0;
 
+        if (power_take_batch_request()) board_restart();
+        bool board_active = board_update(&landed_balls);
+        power_end_frame(board_active, landed_balls, frame_start_us);
     }
 
     return 0;